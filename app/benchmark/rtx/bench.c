@@ -0,0 +1,64 @@
+#include "bench.h"
+
+static uint32_t bench_samples[BENCH_SAMPLES];
+
+void bench_stat_init(struct bench_stat *st)
+{
+	st->min = 0xFFFFFFFF;
+	st->max = 0;
+	st->sum = 0;
+	st->cnt = 0;
+}
+
+void bench_stat_add(struct bench_stat *st, uint32_t cycles)
+{
+	if (st->cnt < BENCH_SAMPLES)
+		bench_samples[st->cnt] = cycles;
+	if (cycles < st->min)
+		st->min = cycles;
+	if (cycles > st->max)
+		st->max = cycles;
+	st->sum += cycles;
+	st->cnt++;
+}
+
+/* Nearest rank 99th percentile of the kept samples */
+static uint32_t bench_stat_p99(struct bench_stat *st)
+{
+	uint32_t n, i, j, v;
+
+	n = st->cnt < BENCH_SAMPLES ? st->cnt : BENCH_SAMPLES;
+	if (n == 0)
+		return 0;
+
+	for (i = 1; i < n; i++) {
+		v = bench_samples[i];
+		for (j = i; j > 0 && bench_samples[j - 1] > v; j--)
+			bench_samples[j] = bench_samples[j - 1];
+		bench_samples[j] = v;
+	}
+	return bench_samples[(n * 99 + 99) / 100 - 1];
+}
+
+/*
+ * One line per measurement, as space separated key=value pairs, so the
+ * log can be parsed by scripts:
+ *
+ *   bench=rdyq tasks=8 samples=256 min=.. mean=.. p99=.. max=.. unit=cycles
+ *
+ * param is left out when NULL.
+ */
+void bench_stat_print(const char *name, const char *param, int value,
+		      struct bench_stat *st)
+{
+	int min = st->cnt ? st->min : 0;
+	int mean = st->cnt ? st->sum / st->cnt : 0;
+	int p99 = bench_stat_p99(st);
+
+	if (param)
+		printf("bench=%s %s=%d ", name, param, value);
+	else
+		printf("bench=%s ", name);
+	printf("samples=%d min=%d mean=%d p99=%d max=%d unit=%s\r\n",
+	       st->cnt, min, mean, p99, st->max, BENCH_UNIT);
+}
@@ -0,0 +1,127 @@
+#ifndef __BENCH_H
+#define __BENCH_H
+
+#include "common.h"
+#include "cmsis_os.h"
+
+void bench_irq_handler(void);
+
+#ifdef TARGET_POSIX
+#include <time.h>
+
+#define BENCH_UNIT		"ns"
+
+/* Host build: nanoseconds of the monotonic clock stand in for cycles */
+static inline void bench_cycles_init(void)
+{
+}
+
+static inline uint32_t bench_cycles(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+/* Run the handler as an interrupt of the emulated core */
+extern void rt_irq_run(void (*isr)(void));
+
+static inline void bench_irq_trigger(void)
+{
+	rt_irq_run(bench_irq_handler);
+}
+
+static inline void bench_irq_init(void)
+{
+}
+#else
+#define BENCH_UNIT		"cycles"
+
+/* DWT cycle counter of the Cortex-M3/M4 debug unit */
+#define BENCH_DEMCR		(*((volatile uint32_t *)0xE000EDFC))
+#define BENCH_DWT_CTRL		(*((volatile uint32_t *)0xE0001000))
+#define BENCH_DWT_CYCCNT	(*((volatile uint32_t *)0xE0001004))
+
+static inline void bench_cycles_init(void)
+{
+	BENCH_DEMCR |= 0x01000000;	/* TRCENA */
+	BENCH_DWT_CYCCNT = 0;
+	BENCH_DWT_CTRL |= 0x00000001;	/* CYCCNTENA */
+}
+
+static inline uint32_t bench_cycles(void)
+{
+	return BENCH_DWT_CYCCNT;
+}
+
+/*
+ * The DebugMonitor exception serves as a software interrupt: MON_PEND
+ * pends it without a debugger attached, the bench defines its handler.
+ */
+static inline void bench_irq_trigger(void)
+{
+	BENCH_DEMCR |= 0x00020000;	/* MON_PEND */
+	__asm volatile ("dsb\n\tisb" ::: "memory");
+}
+
+/*
+ * The handler calls the kernel, so with CONFIG_RTX_BASEPRI it must not
+ * be above the kernel mask.
+ */
+#define BENCH_DEBUGMON_PRIO	(*((volatile uint8_t *)0xE000ED20))
+#ifdef CONFIG_RTX_BASEPRI
+#define BENCH_IRQ_PRIO		CONFIG_RTX_BASEPRI_LEVEL
+#else
+#define BENCH_IRQ_PRIO		0x00
+#endif
+
+static inline void bench_irq_init(void)
+{
+	BENCH_DEBUGMON_PRIO = BENCH_IRQ_PRIO;
+}
+
+int bench_zlat_irq(void);
+#endif
+
+/*
+ * Samples of the stat being filled are also kept for the percentiles,
+ * up to BENCH_SAMPLES of them; only one stat may be filled at a time.
+ */
+#define BENCH_SAMPLES		256
+
+struct bench_stat {
+	uint32_t min;
+	uint32_t max;
+	uint32_t sum;
+	uint32_t cnt;
+};
+
+void bench_stat_init(struct bench_stat *st);
+void bench_stat_add(struct bench_stat *st, uint32_t cycles);
+void bench_stat_print(const char *name, const char *param, int value,
+		      struct bench_stat *st);
+
+void bench_rdyq(void);
+void bench_dly(void);
+void bench_ctxsw(void);
+void bench_sem(void);
+void bench_mbox(void);
+void bench_mbox_batch(void);
+void bench_egrp(void);
+void bench_preempt_thr(void);
+void bench_edf(void);
+void bench_period(void);
+void bench_clock(void);
+void bench_msgbuf(void);
+void bench_waitany(void);
+void bench_mutex(void);
+void bench_lock(void);
+void bench_isr(void);
+void bench_isr_burst(void);
+void bench_zlat(void);
+void bench_stack(void);
+void bench_stkcls(void);
+void bench_trace(void);
+
+#endif
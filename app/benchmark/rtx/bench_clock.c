@@ -0,0 +1,37 @@
+#include "bench.h"
+
+/*
+ * Cost of a timestamp from thread mode. osKernelSysTick() is a service
+ * call, osKernelSysTick64() reads the 64-bit clock without one; a sample
+ * is CLOCK_READS back to back calls.
+ */
+
+#define CLOCK_LOOPS	BENCH_SAMPLES
+#define CLOCK_READS	16
+
+void bench_clock(void)
+{
+#ifdef CONFIG_RTX_CLOCK64
+	struct bench_stat st;
+	uint32_t t0;
+	int i, j;
+
+	bench_stat_init(&st);
+	for (i = 0; i < CLOCK_LOOPS; i++) {
+		t0 = bench_cycles();
+		for (j = 0; j < CLOCK_READS; j++)
+			(void)osKernelSysTick();
+		bench_stat_add(&st, (bench_cycles() - t0) / CLOCK_READS);
+	}
+	bench_stat_print("clock", "bits", 32, &st);
+
+	bench_stat_init(&st);
+	for (i = 0; i < CLOCK_LOOPS; i++) {
+		t0 = bench_cycles();
+		for (j = 0; j < CLOCK_READS; j++)
+			(void)osKernelSysTick64();
+		bench_stat_add(&st, (bench_cycles() - t0) / CLOCK_READS);
+	}
+	bench_stat_print("clock", "bits", 64, &st);
+#endif
+}
@@ -0,0 +1,86 @@
+#include "bench.h"
+
+/*
+ * Timeout arm/cancel cost against the number of pending delays.
+ *
+ * Sleeper threads at osPriorityLow sit in long osDelay() calls, so the
+ * delay queue holds one entry per sleeper. Each round main arms a timeout
+ * with osSignalWait() and blocks; the helper thread sets the signal right
+ * away, which cancels the timeout and switches back to main. With the
+ * delta list the timeout is inserted behind every sleeper, with
+ * CONFIG_RTX_DLY_WHEEL the round trip does not depend on their number.
+ *
+ * The sweep stops early when OS_TASKCNT runs out of TCBs.
+ */
+
+#define DLY_MAX_SLEEPERS	64
+#define DLY_LOOPS		256
+#define DLY_TIMEOUT		60000	/* behind all sleepers, never expires */
+
+static osThreadId sleepers[DLY_MAX_SLEEPERS];
+static osThreadId dly_main;
+
+static void dly_sleeper(void const *arg)
+{
+	for (;;)
+		osDelay(30000 + (uintptr_t)arg);
+}
+osThreadDef(dly_sleeper, osPriorityLow, DLY_MAX_SLEEPERS, 0);
+
+static void dly_helper(void const *arg)
+{
+	for (;;) {
+		osSignalWait(0x0001, osWaitForever);
+		osSignalSet(dly_main, 0x0001);
+	}
+}
+osThreadDef(dly_helper, osPriorityBelowNormal, 1, 0);
+
+static void dly_measure(osThreadId helper, int pending)
+{
+	struct bench_stat st;
+	uint32_t t0;
+	int i;
+
+	bench_stat_init(&st);
+	for (i = 0; i < DLY_LOOPS; i++) {
+		osSignalSet(helper, 0x0001);
+		t0 = bench_cycles();
+		osSignalWait(0x0001, DLY_TIMEOUT);
+		bench_stat_add(&st, bench_cycles() - t0);
+	}
+	bench_stat_print("dly", "pending", pending, &st);
+}
+
+void bench_dly(void)
+{
+	osThreadId helper;
+	int n = 0, next = 1;
+
+	dly_main = osThreadGetId();
+	helper = osThreadCreate(osThread(dly_helper), NULL);
+	if (helper == NULL)
+		return;
+
+	dly_measure(helper, 0);
+	while (n < DLY_MAX_SLEEPERS) {
+		sleepers[n] = osThreadCreate(osThread(dly_sleeper),
+					     (void *)(uintptr_t)(n * 13));
+		if (sleepers[n] == NULL)
+			break;
+		n++;
+
+		if (n == next) {
+			/* let the new sleepers run into their delay */
+			osDelay(2);
+			dly_measure(helper, n);
+			next <<= 1;
+		}
+	}
+	if (n < DLY_MAX_SLEEPERS)
+		printf("dly: out of TCBs at %d threads\r\n", n);
+
+	while (n > 0)
+		osThreadTerminate(sleepers[--n]);
+	osThreadTerminate(helper);
+}
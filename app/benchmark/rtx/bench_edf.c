@@ -0,0 +1,126 @@
+#include "bench.h"
+
+/*
+ * Two periodic loads with deadlines equal to their periods and 90% of the
+ * cpu between them: 5 ms of work every 10 ms and 6 ms every 15 ms.
+ *
+ * edf_fp: the shorter period gets the higher fixed priority, the threads
+ * release their jobs with osDelay(). Its jobs run first whenever they are
+ * ready, so the longer one misses deadlines. edf: both threads are
+ * scheduled by deadline with osEdfStart() and osEdfWait(), which meets all
+ * deadlines up to full load.
+ *
+ * Work is a busy loop calibrated in loop counts, so a preempted job does
+ * not count the time it lost. A job misses when it ends later than one
+ * period after its release.
+ */
+
+#define EDF_JOBS	60
+
+#ifdef CONFIG_RTX_EDF
+struct edf_load {
+	uint32_t period;		/* ms */
+	uint32_t work;			/* ms */
+	uint32_t misses;
+};
+
+static struct edf_load edf_load[2] = {
+	{ 10, 5 },
+	{ 15, 6 },
+};
+static osThreadId edf_main;
+static uint32_t edf_loops_ms;
+static int edf_on;
+
+static void edf_work(uint32_t ms)
+{
+	volatile uint32_t n;
+
+	for (n = ms * edf_loops_ms; n; n--)
+		;
+}
+
+static void edf_thread(void const *arg)
+{
+	struct edf_load *ld = &edf_load[(uintptr_t)arg];
+	uint32_t tick_ms = osKernelSysTickMicroSec(1000);
+	uint32_t rel, now;
+	int i;
+
+	ld->misses = 0;
+	if (edf_on)
+		osEdfStart(ld->period, 0);
+	rel = osKernelSysTick();
+	for (i = 0; i < EDF_JOBS; i++) {
+		edf_work(ld->work);
+		now = osKernelSysTick();
+		if (now - rel > ld->period * tick_ms)
+			ld->misses++;
+		rel += ld->period * tick_ms;
+		if (edf_on) {
+			osEdfWait();
+		} else if ((int32_t)(rel - now) > 0) {
+			osDelay((rel - now + tick_ms - 1) / tick_ms);
+		}
+	}
+	/* The kernel counts misses by the same rule */
+	if (edf_on)
+		ld->misses = osEdfMisses(osThreadGetId());
+	osSignalSet(edf_main, 1 << (uintptr_t)arg);
+	for (;;)
+		osDelay(1000);
+}
+osThreadDef(edf_thread, osPriorityAboveNormal, 2, 0);
+
+static void edf_calibrate(void)
+{
+	uint32_t tick_ms = osKernelSysTickMicroSec(1000);
+	uint32_t t0;
+
+	/* 10M loops, then scale to a millisecond */
+	edf_loops_ms = 1000000;
+	osDelay(1);
+	t0 = osKernelSysTick();
+	edf_work(10);
+	edf_loops_ms = 10000000ULL * tick_ms / (osKernelSysTick() - t0);
+}
+
+static void edf_run(int on)
+{
+	osThreadId th[2];
+
+	edf_on = on;
+	osThreadSetPriority(edf_main, osPriorityRealtime);
+	th[0] = osThreadCreate(osThread(edf_thread), (void *)0);
+	th[1] = osThreadCreate(osThread(edf_thread), (void *)1);
+	if (th[0] == NULL || th[1] == NULL) {
+		printf("edf: out of TCBs\r\n");
+		if (th[0] != NULL)
+			osThreadTerminate(th[0]);
+		osThreadSetPriority(edf_main, osPriorityNormal);
+		return;
+	}
+	/* Fixed priorities: the shorter period above */
+	if (!on)
+		osThreadSetPriority(th[0], osPriorityHigh);
+	osThreadSetPriority(edf_main, osPriorityNormal);
+
+	osSignalWait(0x0003, osWaitForever);
+	printf("bench=%s jobs=%d misses_%d=%d misses_%d=%d\r\n",
+	       on ? "edf" : "edf_fp", EDF_JOBS,
+	       (int)edf_load[0].period, (int)edf_load[0].misses,
+	       (int)edf_load[1].period, (int)edf_load[1].misses);
+	osThreadTerminate(th[0]);
+	osThreadTerminate(th[1]);
+}
+#endif
+
+void bench_edf(void)
+{
+#ifdef CONFIG_RTX_EDF
+	edf_main = osThreadGetId();
+	edf_calibrate();
+	edf_run(0);
+	edf_run(1);
+#endif
+}
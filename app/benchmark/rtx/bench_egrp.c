@@ -0,0 +1,101 @@
+#include "bench.h"
+
+/*
+ * Broadcast to EGRP_WAITERS higher priority threads.
+ *
+ * bcast_sem: main releases one semaphore per waiter, each release switches
+ * to the waiter it wakes. bcast_egrp: main sets one flag of an event group
+ * all waiters wait for, which makes them all ready in one pass. Each waiter
+ * answers through a counting semaphore; a sample runs until main has
+ * collected all answers.
+ */
+
+#define EGRP_LOOPS	BENCH_SAMPLES
+#define EGRP_WAITERS	4
+
+#ifdef CONFIG_RTX_EVT_GROUP
+osEventGroupDef(egrp_go);
+osSemaphoreDef(egrp_done);
+osSemaphoreDef(egrp_sem0);
+osSemaphoreDef(egrp_sem1);
+osSemaphoreDef(egrp_sem2);
+osSemaphoreDef(egrp_sem3);
+static osEventGroupId egrp_go;
+static osSemaphoreId egrp_done;
+static osSemaphoreId egrp_sem[EGRP_WAITERS];
+
+static void egrp_waiter(void const *arg)
+{
+	osSemaphoreId sem = egrp_sem[(uintptr_t)arg];
+
+	for (;;) {
+		if (sem != NULL)
+			osSemaphoreWait(sem, osWaitForever);
+		else
+			osEventGroupWait(egrp_go, 0x0001, osEventGroupAny,
+					 osWaitForever);
+		osSemaphoreRelease(egrp_done);
+	}
+}
+osThreadDef(egrp_waiter, osPriorityHigh, EGRP_WAITERS, 0);
+
+static int egrp_run(int use_egrp)
+{
+	struct bench_stat st;
+	osThreadId th[EGRP_WAITERS];
+	uint32_t t0;
+	int i, j;
+
+	for (j = 0; j < EGRP_WAITERS; j++) {
+		th[j] = osThreadCreate(osThread(egrp_waiter),
+				       (void *)(uintptr_t)j);
+		if (th[j] == NULL) {
+			while (j--)
+				osThreadTerminate(th[j]);
+			return -1;
+		}
+	}
+
+	bench_stat_init(&st);
+	for (i = 0; i < EGRP_LOOPS; i++) {
+		t0 = bench_cycles();
+		if (use_egrp) {
+			osEventGroupSet(egrp_go, 0x0001);
+		} else {
+			for (j = 0; j < EGRP_WAITERS; j++)
+				osSemaphoreRelease(egrp_sem[j]);
+		}
+		for (j = 0; j < EGRP_WAITERS; j++)
+			osSemaphoreWait(egrp_done, osWaitForever);
+		bench_stat_add(&st, bench_cycles() - t0);
+	}
+	bench_stat_print(use_egrp ? "bcast_egrp" : "bcast_sem", "waiters",
+			 EGRP_WAITERS, &st);
+
+	for (j = 0; j < EGRP_WAITERS; j++)
+		osThreadTerminate(th[j]);
+	return 0;
+}
+#endif
+
+void bench_egrp(void)
+{
+#ifdef CONFIG_RTX_EVT_GROUP
+	int i;
+
+	egrp_go = osEventGroupCreate(osEventGroup(egrp_go));
+	egrp_done = osSemaphoreCreate(osSemaphore(egrp_done), 0);
+	egrp_sem[0] = osSemaphoreCreate(osSemaphore(egrp_sem0), 0);
+	egrp_sem[1] = osSemaphoreCreate(osSemaphore(egrp_sem1), 0);
+	egrp_sem[2] = osSemaphoreCreate(osSemaphore(egrp_sem2), 0);
+	egrp_sem[3] = osSemaphoreCreate(osSemaphore(egrp_sem3), 0);
+
+	if (egrp_run(0) < 0) {
+		printf("bcast: out of TCBs\r\n");
+		return;
+	}
+	for (i = 0; i < EGRP_WAITERS; i++)
+		egrp_sem[i] = NULL;
+	egrp_run(1);
+#endif
+}
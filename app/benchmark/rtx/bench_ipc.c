@@ -0,0 +1,205 @@
+#include "bench.h"
+
+/*
+ * Thread to thread latencies through the CMSIS-RTOS primitives.
+ *
+ * ctxsw: two threads of the same priority pass the cpu to each other with
+ * osThreadYield(); each sample runs from the stamp taken before the yield
+ * to the other thread returning from its own yield.
+ *
+ * sem, mbox: main releases a semaphore or puts a message that wakes a
+ * higher priority peer, which answers through a second semaphore or
+ * queue and blocks again. A sample is the whole round trip, two thread
+ * switches included.
+ *
+ * mbox_batch: main hands BATCH_LEN messages to a higher priority peer,
+ * one osMessagePut() at a time or with one osMessagePutN(); the peer
+ * drains them with osMessageGetN() and answers once all have arrived.
+ * A sample is the round trip of the whole batch.
+ */
+
+#define IPC_LOOPS	BENCH_SAMPLES
+#define BATCH_LEN	16
+
+static osThreadId ipc_main;
+static struct bench_stat ipc_st;
+static volatile uint32_t ipc_t0;
+
+static void ctxsw_thread(void const *arg)
+{
+	uint32_t t1;
+
+	for (;;) {
+		ipc_t0 = bench_cycles();
+		osThreadYield();
+		t1 = bench_cycles();
+		if (ipc_st.cnt >= IPC_LOOPS)
+			break;
+		bench_stat_add(&ipc_st, t1 - ipc_t0);
+	}
+	osSignalSet(ipc_main, (uintptr_t)arg);
+}
+osThreadDef(ctxsw_thread, osPriorityAboveNormal, 2, 0);
+
+void bench_ctxsw(void)
+{
+	ipc_main = osThreadGetId();
+	bench_stat_init(&ipc_st);
+
+	/* Both threads must be ready before the first yield */
+	osThreadSetPriority(ipc_main, osPriorityHigh);
+	if (osThreadCreate(osThread(ctxsw_thread), (void *)0x0001) == NULL ||
+	    osThreadCreate(osThread(ctxsw_thread), (void *)0x0002) == NULL) {
+		osThreadSetPriority(ipc_main, osPriorityNormal);
+		printf("ctxsw: out of TCBs\r\n");
+		return;
+	}
+	osThreadSetPriority(ipc_main, osPriorityNormal);
+
+	osSignalWait(0x0003, osWaitForever);
+	bench_stat_print("ctxsw", NULL, 0, &ipc_st);
+}
+
+osSemaphoreDef(sem_ping);
+osSemaphoreDef(sem_pong);
+static osSemaphoreId sem_ping, sem_pong;
+
+static void sem_peer(void const *arg)
+{
+	for (;;) {
+		osSemaphoreWait(sem_ping, osWaitForever);
+		osSemaphoreRelease(sem_pong);
+	}
+}
+osThreadDef(sem_peer, osPriorityHigh, 1, 0);
+
+void bench_sem(void)
+{
+	osThreadId peer;
+	uint32_t t0;
+	int i;
+
+	sem_ping = osSemaphoreCreate(osSemaphore(sem_ping), 0);
+	sem_pong = osSemaphoreCreate(osSemaphore(sem_pong), 0);
+	peer = osThreadCreate(osThread(sem_peer), NULL);
+	if (peer == NULL) {
+		printf("sem: out of TCBs\r\n");
+		return;
+	}
+
+	bench_stat_init(&ipc_st);
+	for (i = 0; i < IPC_LOOPS; i++) {
+		t0 = bench_cycles();
+		osSemaphoreRelease(sem_ping);
+		osSemaphoreWait(sem_pong, osWaitForever);
+		bench_stat_add(&ipc_st, bench_cycles() - t0);
+	}
+	bench_stat_print("sem", NULL, 0, &ipc_st);
+
+	osThreadTerminate(peer);
+}
+
+osMessageQDef(mbox_req, 4, uint32_t);
+osMessageQDef(mbox_rsp, 4, uint32_t);
+static osMessageQId mbox_req, mbox_rsp;
+
+static void mbox_peer(void const *arg)
+{
+	osEvent evt;
+
+	for (;;) {
+		evt = osMessageGet(mbox_req, osWaitForever);
+		osMessagePut(mbox_rsp, evt.value.v + 1, osWaitForever);
+	}
+}
+osThreadDef(mbox_peer, osPriorityHigh, 1, 0);
+
+void bench_mbox(void)
+{
+	osThreadId peer;
+	uint32_t t0;
+	int i;
+
+	mbox_req = osMessageCreate(osMessageQ(mbox_req), NULL);
+	mbox_rsp = osMessageCreate(osMessageQ(mbox_rsp), NULL);
+	peer = osThreadCreate(osThread(mbox_peer), NULL);
+	if (peer == NULL) {
+		printf("mbox: out of TCBs\r\n");
+		return;
+	}
+
+	bench_stat_init(&ipc_st);
+	for (i = 0; i < IPC_LOOPS; i++) {
+		t0 = bench_cycles();
+		osMessagePut(mbox_req, i, osWaitForever);
+		osMessageGet(mbox_rsp, osWaitForever);
+		bench_stat_add(&ipc_st, bench_cycles() - t0);
+	}
+	bench_stat_print("mbox", NULL, 0, &ipc_st);
+
+	osThreadTerminate(peer);
+}
+
+osMessageQDef(batch_q, BATCH_LEN, uint32_t);
+static osMessageQId batch_q;
+
+static void batch_peer(void const *arg)
+{
+	uint32_t msg[BATCH_LEN];
+	int n = 0;
+
+	for (;;) {
+		n += osMessageGetN(batch_q, msg, BATCH_LEN, osWaitForever);
+		if (n >= BATCH_LEN) {
+			n -= BATCH_LEN;
+			osSemaphoreRelease(sem_pong);
+		}
+	}
+}
+osThreadDef(batch_peer, osPriorityHigh, 1, 0);
+
+static void batch_run(int batch)
+{
+	uint32_t msg[BATCH_LEN];
+	uint32_t t0;
+	int i, j, n;
+
+	for (j = 0; j < BATCH_LEN; j++)
+		msg[j] = j;
+
+	bench_stat_init(&ipc_st);
+	for (i = 0; i < IPC_LOOPS; i++) {
+		t0 = bench_cycles();
+		if (batch) {
+			for (j = 0; j < BATCH_LEN; j += n)
+				n = osMessagePutN(batch_q, &msg[j], BATCH_LEN - j,
+						  osWaitForever);
+		} else {
+			for (j = 0; j < BATCH_LEN; j++)
+				osMessagePut(batch_q, msg[j], osWaitForever);
+		}
+		osSemaphoreWait(sem_pong, osWaitForever);
+		bench_stat_add(&ipc_st, bench_cycles() - t0);
+	}
+	bench_stat_print("mbox_batch", "batch", batch ? BATCH_LEN : 1,
+			 &ipc_st);
+}
+
+void bench_mbox_batch(void)
+{
+	osThreadId peer;
+
+	batch_q = osMessageCreate(osMessageQ(batch_q), NULL);
+	if (sem_pong == NULL)
+		sem_pong = osSemaphoreCreate(osSemaphore(sem_pong), 0);
+	peer = osThreadCreate(osThread(batch_peer), NULL);
+	if (peer == NULL) {
+		printf("mbox_batch: out of TCBs\r\n");
+		return;
+	}
+
+	batch_run(0);
+	batch_run(1);
+
+	osThreadTerminate(peer);
+}
@@ -0,0 +1,129 @@
+#include "bench.h"
+
+/*
+ * Interrupt to thread wakeup latency.
+ *
+ * A high priority thread waits on a semaphore that the interrupt handler
+ * releases. From an ISR the release is only queued to os_psq; the kernel
+ * applies it in PendSV through rt_pop_req() and switches to the waiter.
+ * A sample runs from the software trigger in main to the waiter returning
+ * from osSemaphoreWait().
+ *
+ * isr_burst: the handler releases the semaphore ISR_BURST times, like a
+ * receive interrupt handing over several frames at once. A sample runs
+ * from the trigger to the waiter having taken all the tokens. The use of
+ * the ISR queue over all runs is printed after it.
+ */
+
+#define ISR_LOOPS	BENCH_SAMPLES
+#define ISR_BURST	8
+
+osSemaphoreDef(isr_sem);
+static osSemaphoreId isr_sem;
+static struct bench_stat isr_st;
+static volatile uint32_t isr_t0;
+static volatile int isr_posts = 1;
+
+static void isr_release(void)
+{
+	int i;
+
+	for (i = 0; i < isr_posts; i++)
+		osSemaphoreRelease(isr_sem);
+}
+
+void bench_irq_handler(void)
+{
+#ifdef CONFIG_RTX_TRACE
+	/* Show the handler on the interrupt track of the trace */
+	os_irq_enter();
+	isr_release();
+	os_irq_exit();
+#else
+	isr_release();
+#endif
+}
+
+#ifndef TARGET_POSIX
+void DebugMon_Handler(void)
+{
+	/* The DWT matches of bench_zlat() come here as well */
+	if (bench_zlat_irq())
+		return;
+	bench_irq_handler();
+}
+#endif
+
+static void isr_waiter(void const *arg)
+{
+	uint32_t t1;
+
+	for (;;) {
+		osSemaphoreWait(isr_sem, osWaitForever);
+		t1 = bench_cycles();
+		bench_stat_add(&isr_st, t1 - isr_t0);
+	}
+}
+osThreadDef(isr_waiter, osPriorityHigh, 1, 0);
+
+static void burst_waiter(void const *arg)
+{
+	int i;
+
+	for (;;) {
+		for (i = 0; i < ISR_BURST; i++)
+			osSemaphoreWait(isr_sem, osWaitForever);
+		bench_stat_add(&isr_st, bench_cycles() - isr_t0);
+	}
+}
+osThreadDef(burst_waiter, osPriorityHigh, 1, 0);
+
+void bench_isr(void)
+{
+	osThreadId waiter;
+	int i;
+
+	isr_sem = osSemaphoreCreate(osSemaphore(isr_sem), 0);
+	waiter = osThreadCreate(osThread(isr_waiter), NULL);
+	if (waiter == NULL) {
+		printf("isr: out of TCBs\r\n");
+		return;
+	}
+
+	bench_stat_init(&isr_st);
+	for (i = 0; i < ISR_LOOPS; i++) {
+		isr_t0 = bench_cycles();
+		bench_irq_trigger();
+	}
+	bench_stat_print("isr", NULL, 0, &isr_st);
+
+	osThreadTerminate(waiter);
+}
+
+void bench_isr_burst(void)
+{
+	osThreadId waiter;
+	uint32_t posts, peak, merged, lost;
+	int i;
+
+	waiter = osThreadCreate(osThread(burst_waiter), NULL);
+	if (waiter == NULL) {
+		printf("isr_burst: out of TCBs\r\n");
+		return;
+	}
+
+	isr_posts = ISR_BURST;
+	bench_stat_init(&isr_st);
+	for (i = 0; i < ISR_LOOPS; i++) {
+		isr_t0 = bench_cycles();
+		bench_irq_trigger();
+	}
+	isr_posts = 1;
+	bench_stat_print("isr_burst", "posts", ISR_BURST, &isr_st);
+
+	osThreadTerminate(waiter);
+
+	posts = os_psq_stat(&peak, &merged, &lost);
+	printf("bench=psq queued=%d merged=%d peak=%d lost=%d\r\n",
+	       posts, merged, peak, lost);
+}
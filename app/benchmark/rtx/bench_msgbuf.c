@@ -0,0 +1,103 @@
+#include "bench.h"
+
+/*
+ * Zero-copy message buffer round trips between main and a higher
+ * priority reader.
+ *
+ * msgbuf: main reserves a record of MBF_LEN bytes, fills it in place and
+ * commits it; the reader, blocked in osMsgBufPeek(), takes it in place,
+ * releases it and answers through a semaphore. A sample is the round
+ * trip, wake up and switches included.
+ *
+ * msgbuf_wait: the reader waits with osMsgBufWait() for MBF_RECS records
+ * and drains them, so main commits a whole batch of records of growing
+ * length before the reader runs once. A sample is the round trip of the
+ * batch.
+ */
+
+#define MBF_LOOPS	BENCH_SAMPLES
+#define MBF_LEN		64
+#define MBF_RECS	8
+
+#ifdef CONFIG_RTX_MSGBUF
+osMsgBufDef(mbf_buf, 1024);
+osSemaphoreDef(mbf_done);
+static osMsgBufId mbf_buf;
+static osSemaphoreId mbf_done;
+static volatile uint32_t mbf_sum;
+static volatile int mbf_recs = 1;
+
+static void mbf_reader(void const *arg)
+{
+	uint32_t *data;
+	uint32_t len;
+	int i;
+
+	for (;;) {
+		if (mbf_recs > 1)
+			osMsgBufWait(mbf_buf, 0, mbf_recs, osWaitForever);
+		for (i = 0; i < mbf_recs; i++) {
+			data = osMsgBufPeek(mbf_buf, &len, osWaitForever);
+			mbf_sum += data[0] + len;
+			osMsgBufRelease(mbf_buf);
+		}
+		osSemaphoreRelease(mbf_done);
+	}
+}
+osThreadDef(mbf_reader, osPriorityHigh, 1, 0);
+
+static void mbf_write(uint32_t len)
+{
+	uint8_t *data;
+
+	data = osMsgBufReserve(mbf_buf, len);
+	if (data == NULL)
+		return;
+	memset(data, (int)len, len);
+	osMsgBufCommit(mbf_buf, len);
+}
+#endif
+
+void bench_msgbuf(void)
+{
+#ifdef CONFIG_RTX_MSGBUF
+	struct bench_stat st;
+	osThreadId reader;
+	uint32_t t0;
+	int i, j;
+
+	mbf_buf = osMsgBufCreate(osMsgBuf(mbf_buf));
+	mbf_done = osSemaphoreCreate(osSemaphore(mbf_done), 0);
+	reader = osThreadCreate(osThread(mbf_reader), NULL);
+	if (reader == NULL) {
+		printf("msgbuf: out of TCBs\r\n");
+		return;
+	}
+
+	bench_stat_init(&st);
+	for (i = 0; i < MBF_LOOPS; i++) {
+		t0 = bench_cycles();
+		mbf_write(MBF_LEN);
+		osSemaphoreWait(mbf_done, osWaitForever);
+		bench_stat_add(&st, bench_cycles() - t0);
+	}
+	bench_stat_print("msgbuf", "len", MBF_LEN, &st);
+
+	/* The reader is back in osMsgBufPeek() for a single record */
+	osThreadTerminate(reader);
+	mbf_recs = MBF_RECS;
+	reader = osThreadCreate(osThread(mbf_reader), NULL);
+
+	bench_stat_init(&st);
+	for (i = 0; i < MBF_LOOPS; i++) {
+		t0 = bench_cycles();
+		for (j = 0; j < MBF_RECS; j++)
+			mbf_write(16 * (j + 1));
+		osSemaphoreWait(mbf_done, osWaitForever);
+		bench_stat_add(&st, bench_cycles() - t0);
+	}
+	bench_stat_print("msgbuf_wait", "records", MBF_RECS, &st);
+
+	osThreadTerminate(reader);
+#endif
+}
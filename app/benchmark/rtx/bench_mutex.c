@@ -0,0 +1,121 @@
+#include "bench.h"
+
+/*
+ * Mutex handoff under priority inheritance.
+ *
+ * The low priority owner takes the mutex and wakes the high priority
+ * waiter, which blocks on the mutex and lends its priority to the owner.
+ * A sample runs from the owner's osMutexRelease() to the waiter returning
+ * from osMutexWait() with the mutex, the priority of the owner is dropped
+ * back on the way. main only paces the rounds.
+ *
+ * lock_mutex, lock_sem: cost of an uncontended osMutexWait() and
+ * osMutexRelease() pair, and of an osSemaphoreWait() and
+ * osSemaphoreRelease() pair on a semaphore with a token, in one thread.
+ * With CONFIG_RTX_FAST_SYNC neither call enters the kernel.
+ */
+
+#define MUTEX_LOOPS	BENCH_SAMPLES
+
+osMutexDef(mutex_pi);
+static osMutexId mutex_pi;
+static osThreadId mutex_main, mutex_high;
+static struct bench_stat mutex_st;
+static volatile uint32_t mutex_t0;
+static int mutex_inherited;
+
+static void mutex_waiter(void const *arg)
+{
+	uint32_t t1;
+
+	for (;;) {
+		osSignalWait(0x0001, osWaitForever);
+		osMutexWait(mutex_pi, osWaitForever);
+		t1 = bench_cycles();
+		bench_stat_add(&mutex_st, t1 - mutex_t0);
+		osMutexRelease(mutex_pi);
+	}
+}
+osThreadDef(mutex_waiter, osPriorityHigh, 1, 0);
+
+static void mutex_owner(void const *arg)
+{
+	for (;;) {
+		osSignalWait(0x0001, osWaitForever);
+		osMutexWait(mutex_pi, osWaitForever);
+		osSignalSet(mutex_high, 0x0001);
+		if (osThreadGetPriority(osThreadGetId()) == osPriorityHigh)
+			mutex_inherited++;
+		mutex_t0 = bench_cycles();
+		osMutexRelease(mutex_pi);
+		osSignalSet(mutex_main, 0x0001);
+	}
+}
+osThreadDef(mutex_owner, osPriorityBelowNormal, 1, 0);
+
+void bench_mutex(void)
+{
+	osThreadId low;
+	int i;
+
+	mutex_main = osThreadGetId();
+	mutex_pi = osMutexCreate(osMutex(mutex_pi));
+	mutex_high = osThreadCreate(osThread(mutex_waiter), NULL);
+	low = osThreadCreate(osThread(mutex_owner), NULL);
+	if (mutex_high == NULL || low == NULL) {
+		printf("mutex: out of TCBs\r\n");
+		goto out;
+	}
+
+	bench_stat_init(&mutex_st);
+	mutex_inherited = 0;
+	for (i = 0; i < MUTEX_LOOPS; i++) {
+		osSignalSet(low, 0x0001);
+		osSignalWait(0x0001, osWaitForever);
+	}
+	bench_stat_print("mutex", NULL, 0, &mutex_st);
+	if (mutex_inherited != MUTEX_LOOPS)
+		printf("mutex: priority inherited in %d of %d rounds\r\n",
+		       mutex_inherited, MUTEX_LOOPS);
+
+out:
+	if (low)
+		osThreadTerminate(low);
+	if (mutex_high)
+		osThreadTerminate(mutex_high);
+}
+
+osMutexDef(mutex_lock);
+osSemaphoreDef(sem_lock);
+
+void bench_lock(void)
+{
+	osMutexId mutex;
+	osSemaphoreId sem;
+	uint32_t t0;
+	int i;
+
+	mutex = osMutexCreate(osMutex(mutex_lock));
+	sem = osSemaphoreCreate(osSemaphore(sem_lock), 1);
+
+	bench_stat_init(&mutex_st);
+	for (i = 0; i < MUTEX_LOOPS; i++) {
+		t0 = bench_cycles();
+		osMutexWait(mutex, osWaitForever);
+		osMutexRelease(mutex);
+		bench_stat_add(&mutex_st, bench_cycles() - t0);
+	}
+	bench_stat_print("lock_mutex", NULL, 0, &mutex_st);
+
+	bench_stat_init(&mutex_st);
+	for (i = 0; i < MUTEX_LOOPS; i++) {
+		t0 = bench_cycles();
+		osSemaphoreWait(sem, osWaitForever);
+		osSemaphoreRelease(sem);
+		bench_stat_add(&mutex_st, bench_cycles() - t0);
+	}
+	bench_stat_print("lock_sem", NULL, 0, &mutex_st);
+
+	osMutexDelete(mutex);
+	osSemaphoreDelete(sem);
+}
@@ -0,0 +1,68 @@
+#include "bench.h"
+
+/*
+ * A loop with PERIOD_MS between job releases and PERIOD_WORK_US of work
+ * per job, run for PERIOD_JOBS jobs.
+ *
+ * period_delay paces the loop with osDelay(PERIOD_MS) after the work, so
+ * every job starts the work time plus up to a tick late and the error adds
+ * up. period releases the jobs with osPeriodWait() on the grid of the
+ * first release. drift_us is the start of the last job against its
+ * nominal release; the period line adds the release jitter kept in the
+ * osPeriod block.
+ */
+
+#define PERIOD_MS	5
+#define PERIOD_WORK_US	1500
+#define PERIOD_JOBS	100
+
+#ifdef CONFIG_RTX_PERIODIC
+static void period_work(void)
+{
+	uint32_t work = osKernelSysTickMicroSec(PERIOD_WORK_US);
+	uint32_t t0 = osKernelSysTick();
+
+	while (osKernelSysTick() - t0 < work)
+		;
+}
+
+static void period_run(int grid)
+{
+	osPeriod pd;
+	uint32_t us = osKernelSysTickMicroSec(1);
+	uint32_t t0, last = 0;
+	int i;
+
+	osDelay(1);
+	if (grid)
+		osPeriodStart(&pd, PERIOD_MS);
+	t0 = osKernelSysTick();
+	for (i = 0; i < PERIOD_JOBS; i++) {
+		last = osKernelSysTick();
+		period_work();
+		if (grid)
+			osPeriodWait(&pd);
+		else
+			osDelay(PERIOD_MS);
+	}
+	last -= t0 + osKernelSysTickMicroSec(PERIOD_MS * 1000) *
+		     (PERIOD_JOBS - 1);
+	printf("bench=%s jobs=%d drift_us=%d\r\n",
+	       grid ? "period" : "period_delay", PERIOD_JOBS,
+	       (int)last / (int)us);
+	if (!grid)
+		return;
+	printf("bench=period_stat overruns=%d jitter_max_us=%d "
+	       "jitter_avg_us=%d exec_max_us=%d\r\n", (int)pd.overruns,
+	       (int)(pd.jitter_max / us), (int)(pd.jitter_sum / pd.jobs / us),
+	       (int)(pd.exec_max / us));
+}
+#endif
+
+void bench_period(void)
+{
+#ifdef CONFIG_RTX_PERIODIC
+	period_run(0);
+	period_run(1);
+#endif
+}
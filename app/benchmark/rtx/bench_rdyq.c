@@ -0,0 +1,66 @@
+#include "bench.h"
+
+/*
+ * Ready queue latency against the number of ready threads.
+ *
+ * Filler threads are created at osPriorityLow and never get the cpu while
+ * main runs at osPriorityNormal, so they all stay in the ready queue. The
+ * probe is the last created filler: its priority is toggled between
+ * osPriorityLow and osPriorityBelowNormal, which removes it from and puts
+ * it back into the ready queue behind all other fillers. With the sorted
+ * ready list both steps walk the list, with CONFIG_RTX_RDYQ_BITMAP the
+ * time is flat.
+ *
+ * The sweep stops early when OS_TASKCNT runs out of TCBs; set it to 66 or
+ * more in the board cmsis_rtx.h to reach 64 ready threads.
+ */
+
+#define RDYQ_MAX_TASKS	64
+#define RDYQ_LOOPS	256
+
+static osThreadId fillers[RDYQ_MAX_TASKS];
+
+static void rdyq_filler(void const *arg)
+{
+	for (;;)
+		;
+}
+osThreadDef(rdyq_filler, osPriorityLow, RDYQ_MAX_TASKS, 0);
+
+static void rdyq_measure(osThreadId probe, int tasks)
+{
+	struct bench_stat st;
+	uint32_t t0;
+	int i;
+
+	bench_stat_init(&st);
+	for (i = 0; i < RDYQ_LOOPS; i++) {
+		t0 = bench_cycles();
+		osThreadSetPriority(probe, osPriorityBelowNormal);
+		osThreadSetPriority(probe, osPriorityLow);
+		bench_stat_add(&st, bench_cycles() - t0);
+	}
+	bench_stat_print("rdyq", "tasks", tasks, &st);
+}
+
+void bench_rdyq(void)
+{
+	int n = 0, next = 2;
+
+	while (n < RDYQ_MAX_TASKS) {
+		fillers[n] = osThreadCreate(osThread(rdyq_filler), NULL);
+		if (fillers[n] == NULL)
+			break;
+		n++;
+
+		if (n == next) {
+			rdyq_measure(fillers[n - 1], n);
+			next <<= 1;
+		}
+	}
+	if (n < RDYQ_MAX_TASKS)
+		printf("rdyq: out of TCBs at %d threads\r\n", n);
+
+	while (n > 0)
+		osThreadTerminate(fillers[--n]);
+}
@@ -0,0 +1,80 @@
+#include "bench.h"
+
+/*
+ * Stack sizing report, taken after the other benches ran so the marks
+ * cover their worst case:
+ *
+ *   bench=stack thread=0x20000a10 size=512 used=184 unit=bytes
+ *
+ * thread is the thread ID, or main for the MSP the interrupts run on.
+ */
+
+#ifdef CONFIG_RTX_STK_WATERMARK
+static void stack_line(osThreadId thread_id, uint32_t size, uint32_t used)
+{
+	if (thread_id)
+		printf("bench=stack thread=%p ", thread_id);
+	else
+		printf("bench=stack thread=main ");
+	printf("size=%d used=%d unit=bytes\r\n", size, used);
+}
+#endif
+
+void bench_stack(void)
+{
+#ifdef CONFIG_RTX_STK_WATERMARK
+	os_stack_report(stack_line);
+#endif
+}
+
+/*
+ * Thread create and terminate with a user-provided stack size, the path
+ * that takes a stack size class block or carves the stack from the user
+ * stack area. The thread is below main and never runs. The use of the
+ * classes follows:
+ *
+ *   bench=stkcls class=0 size=256 blocks=2 used=0 peak=1 miss=0
+ */
+
+#ifdef TARGET_POSIX
+#define STKCLS_STACK	6000
+#else
+#define STKCLS_STACK	200
+#endif
+
+static void stkcls_thread(void const *arg)
+{
+}
+osThreadDef(stkcls_thread, osPriorityLow, 1, STKCLS_STACK);
+
+void bench_stkcls(void)
+{
+	struct bench_stat st;
+	osThreadId tid;
+	uint32_t t0;
+	int i;
+#ifdef CONFIG_RTX_STK_POOLS
+	uint32_t cls, size, blocks, used, peak, miss;
+#endif
+
+	bench_stat_init(&st);
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		t0 = bench_cycles();
+		tid = osThreadCreate(osThread(stkcls_thread), NULL);
+		if (tid == NULL) {
+			printf("stkcls: out of stack memory\r\n");
+			return;
+		}
+		osThreadTerminate(tid);
+		bench_stat_add(&st, bench_cycles() - t0);
+	}
+	bench_stat_print("thread_create", "stack", STKCLS_STACK, &st);
+
+#ifdef CONFIG_RTX_STK_POOLS
+	for (cls = 0; cls < 4; cls++) {
+		size = os_stack_class_stat(cls, &blocks, &used, &peak, &miss);
+		printf("bench=stkcls class=%d size=%d blocks=%d used=%d peak=%d miss=%d\r\n",
+		       cls, size, blocks, used, peak, miss);
+	}
+#endif
+}
@@ -0,0 +1,104 @@
+#include "bench.h"
+
+/*
+ * A producer hands THR_BATCH messages to a higher priority consumer, which
+ * answers once the whole batch has arrived. A sample is the round trip of
+ * the batch.
+ *
+ * Without a threshold every osMessagePut() wakes the consumer and switches
+ * to it and back. Created with osThreadCreateEx() and the consumer priority
+ * as threshold, the producer is not preempted by the consumer: the batch is
+ * queued first and the consumer drains it after the producer blocks. The
+ * switches line gives the thread switches per batch.
+ */
+
+#define THR_LOOPS	BENCH_SAMPLES
+#define THR_BATCH	8
+
+#ifdef CONFIG_RTX_PREEMPT_THR
+osMessageQDef(thr_q, THR_BATCH, uint32_t);
+osSemaphoreDef(thr_done);
+static osMessageQId thr_q;
+static osSemaphoreId thr_done;
+static osThreadId thr_main;
+static volatile uint32_t thr_runs;
+
+static void thr_consumer(void const *arg)
+{
+	int n = 0;
+
+	for (;;) {
+		osMessageGet(thr_q, osWaitForever);
+		thr_runs++;
+		if (++n == THR_BATCH) {
+			n = 0;
+			osSemaphoreRelease(thr_done);
+		}
+	}
+}
+osThreadDef(thr_consumer, osPriorityAboveNormal, 1, 0);
+
+static void thr_producer(void const *arg)
+{
+	struct bench_stat st;
+	uint32_t t0, runs, preempts = 0;
+	int i, j;
+
+	bench_stat_init(&st);
+	for (i = 0; i < THR_LOOPS; i++) {
+		t0 = bench_cycles();
+		for (j = 0; j < THR_BATCH; j++) {
+			runs = thr_runs;
+			osMessagePut(thr_q, j, osWaitForever);
+			if (thr_runs != runs)
+				preempts++;
+		}
+		osSemaphoreWait(thr_done, osWaitForever);
+		bench_stat_add(&st, bench_cycles() - t0);
+	}
+	bench_stat_print("preempt_thr", "thr", (uintptr_t)arg, &st);
+	/* Two switches per preemption, two more around the final wait */
+	printf("bench=preempt_thr_sw thr=%d switches=%d\r\n",
+	       (int)(uintptr_t)arg, (int)(2 * preempts / THR_LOOPS + 2));
+
+	osSignalSet(thr_main, 0x0001);
+}
+osThreadDef(thr_producer, osPriorityNormal, 1, 0);
+
+static int thr_run(int thr)
+{
+	osThreadId cons, prod;
+
+	cons = osThreadCreate(osThread(thr_consumer), NULL);
+	if (cons == NULL)
+		return -1;
+	if (thr)
+		prod = osThreadCreateEx(osThread(thr_producer), (void *)1,
+					osPriorityAboveNormal);
+	else
+		prod = osThreadCreate(osThread(thr_producer), (void *)0);
+	if (prod == NULL) {
+		osThreadTerminate(cons);
+		return -1;
+	}
+
+	osSignalWait(0x0001, osWaitForever);
+	osThreadTerminate(cons);
+	return 0;
+}
+#endif
+
+void bench_preempt_thr(void)
+{
+#ifdef CONFIG_RTX_PREEMPT_THR
+	thr_main = osThreadGetId();
+	thr_q = osMessageCreate(osMessageQ(thr_q), NULL);
+	thr_done = osSemaphoreCreate(osSemaphore(thr_done), 0);
+
+	if (thr_run(0) < 0) {
+		printf("preempt_thr: out of TCBs\r\n");
+		return;
+	}
+	thr_run(1);
+#endif
+}
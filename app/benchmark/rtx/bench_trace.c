@@ -0,0 +1,31 @@
+#include "bench.h"
+
+/*
+ * Dump of the kernel event trace, as hex words on the console:
+ *
+ *   trace=54585452,80001,a037a00,200
+ *   trace=1a2b3c4d,1020001,...
+ *
+ * The first line is the header from os_trace_header(), then come the
+ * records, TRACE_WORDS words per line. scripts/rtx_trace.py takes the
+ * whole log and picks the trace= lines out of it.
+ */
+
+#define TRACE_WORDS	8
+
+void bench_trace(void)
+{
+#ifdef CONFIG_RTX_TRACE
+	uint32_t buf[TRACE_WORDS];
+	uint32_t i, n;
+
+	n = os_trace_header(buf) / 4;
+	do {
+		printf("trace=");
+		for (i = 0; i < n; i++)
+			printf(i ? ",%x" : "%x", buf[i]);
+		printf("\r\n");
+		n = os_trace_read(buf, sizeof(buf)) / 4;
+	} while (n);
+#endif
+}
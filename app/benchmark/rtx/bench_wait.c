@@ -0,0 +1,76 @@
+#include "bench.h"
+
+/*
+ * Multi-object wait round trips.
+ *
+ * waitany: a higher priority event loop thread waits with osWaitAny() on
+ * a semaphore, a message queue and a signal flag at once; main wakes it
+ * through each of the three in turn and the loop answers through a second
+ * semaphore. A sample is the round trip, to be set against the single
+ * object ones of bench=sem and bench=mbox.
+ */
+
+#define WAIT_LOOPS	BENCH_SAMPLES
+#define WAIT_SOURCES	3
+
+#ifdef CONFIG_RTX_WAIT_ANY
+osSemaphoreDef(wait_sem);
+osSemaphoreDef(wait_done);
+osMessageQDef(wait_q, 4, uint32_t);
+static osSemaphoreId wait_sem, wait_done;
+static osMessageQId wait_q;
+
+static void wait_loop(void const *arg)
+{
+	void *objs[2];
+	uint32_t value;
+
+	objs[0] = wait_sem;
+	objs[1] = wait_q;
+	for (;;) {
+		osWaitAny(objs, 2, 0x0001, &value, osWaitForever);
+		osSemaphoreRelease(wait_done);
+	}
+}
+osThreadDef(wait_loop, osPriorityHigh, 1, 0);
+#endif
+
+void bench_waitany(void)
+{
+#ifdef CONFIG_RTX_WAIT_ANY
+	struct bench_stat st;
+	osThreadId loop;
+	uint32_t t0;
+	int i;
+
+	wait_sem = osSemaphoreCreate(osSemaphore(wait_sem), 0);
+	wait_done = osSemaphoreCreate(osSemaphore(wait_done), 0);
+	wait_q = osMessageCreate(osMessageQ(wait_q), NULL);
+	loop = osThreadCreate(osThread(wait_loop), NULL);
+	if (loop == NULL) {
+		printf("waitany: out of TCBs\r\n");
+		return;
+	}
+
+	bench_stat_init(&st);
+	for (i = 0; i < WAIT_LOOPS; i++) {
+		t0 = bench_cycles();
+		switch (i % WAIT_SOURCES) {
+		case 0:
+			osSemaphoreRelease(wait_sem);
+			break;
+		case 1:
+			osMessagePut(wait_q, i, osWaitForever);
+			break;
+		default:
+			osSignalSet(loop, 0x0001);
+			break;
+		}
+		osSemaphoreWait(wait_done, osWaitForever);
+		bench_stat_add(&st, bench_cycles() - t0);
+	}
+	bench_stat_print("waitany", "sources", WAIT_SOURCES, &st);
+
+	osThreadTerminate(loop);
+#endif
+}
@@ -0,0 +1,114 @@
+#include "bench.h"
+
+/*
+ * Entry latency of an interrupt above the kernel.
+ *
+ * Comparator 0 of the DWT watches the cycle counter and raises the
+ * DebugMonitor exception at a known cycle, while a thread below main
+ * keeps the kernel busy with pool, semaphore and yield calls and main
+ * wakes up on every tick. The exception is given the highest priority
+ * and its handler does not use the kernel; a sample is the cycle the
+ * handler starts at minus the compare value, exception entry included.
+ * Every match arms the next one 2000 to 6095 cycles later, a pseudo
+ * random distance, so that the samples land anywhere in the kernel.
+ *
+ * With CONFIG_RTX_BASEPRI (basepri= printed as the mask value) the max
+ * stays at the bare entry cost; with basepri=0 the kernel still sets
+ * PRIMASK and the max grows by the longest critical section hit. Monitor
+ * mode debug events are only taken when no debugger halts the core.
+ */
+
+#define ZLAT_LOOPS		(BENCH_SAMPLES * 16)
+
+#ifdef CONFIG_RTX_BASEPRI
+#define ZLAT_BASEPRI		CONFIG_RTX_BASEPRI_LEVEL
+#else
+#define ZLAT_BASEPRI		0
+#endif
+
+#ifndef TARGET_POSIX
+#define ZLAT_DFSR		(*((volatile uint32_t *)0xE000ED30))
+#define ZLAT_DWT_COMP0		(*((volatile uint32_t *)0xE0001020))
+#define ZLAT_DWT_MASK0		(*((volatile uint32_t *)0xE0001024))
+#define ZLAT_DWT_FUNCTION0	(*((volatile uint32_t *)0xE0001028))
+
+#define ZLAT_DEMCR_MON_EN	0x00010000
+#define ZLAT_DFSR_DWTTRAP	0x00000004
+#define ZLAT_CYCMATCH		0x00000084	/* CYCMATCH, watchpoint event */
+
+static struct bench_stat zlat_st;
+static uint32_t zlat_seed = 1;
+
+static void zlat_arm(void)
+{
+	zlat_seed = zlat_seed * 1664525 + 1013904223;
+	ZLAT_DWT_COMP0 = bench_cycles() + 2000 + (zlat_seed >> 20);
+}
+
+/* Called first by the DebugMonitor handler, 1 if it was a DWT match */
+int bench_zlat_irq(void)
+{
+	uint32_t now = bench_cycles();
+
+	if (!(ZLAT_DFSR & ZLAT_DFSR_DWTTRAP))
+		return 0;
+	ZLAT_DFSR = ZLAT_DFSR_DWTTRAP;
+	(void)ZLAT_DWT_FUNCTION0;	/* clears MATCHED */
+
+	bench_stat_add(&zlat_st, now - ZLAT_DWT_COMP0);
+	if (zlat_st.cnt < ZLAT_LOOPS)
+		zlat_arm();
+	else
+		ZLAT_DWT_FUNCTION0 = 0;
+	return 1;
+}
+
+osPoolDef(zlat_pool, 4, uint32_t);
+osSemaphoreDef(zlat_sem);
+static osPoolId zlat_pool;
+static osSemaphoreId zlat_sem;
+
+static void zlat_load(void const *arg)
+{
+	void *blk;
+
+	for (;;) {
+		blk = osPoolAlloc(zlat_pool);
+		osSemaphoreRelease(zlat_sem);
+		osSemaphoreWait(zlat_sem, 0);
+		osPoolFree(zlat_pool, blk);
+		osThreadYield();
+	}
+}
+osThreadDef(zlat_load, osPriorityBelowNormal, 1, 0);
+#endif
+
+void bench_zlat(void)
+{
+#ifndef TARGET_POSIX
+	osThreadId load;
+
+	zlat_pool = osPoolCreate(osPool(zlat_pool));
+	zlat_sem = osSemaphoreCreate(osSemaphore(zlat_sem), 0);
+	load = osThreadCreate(osThread(zlat_load), NULL);
+	if (load == NULL) {
+		printf("zlat: out of TCBs\r\n");
+		return;
+	}
+
+	bench_stat_init(&zlat_st);
+	BENCH_DEBUGMON_PRIO = 0x00;
+	BENCH_DEMCR |= ZLAT_DEMCR_MON_EN;
+	ZLAT_DWT_MASK0 = 0;
+	zlat_arm();
+	ZLAT_DWT_FUNCTION0 = ZLAT_CYCMATCH;
+
+	while (zlat_st.cnt < ZLAT_LOOPS)
+		osDelay(1);
+
+	BENCH_DEMCR &= ~ZLAT_DEMCR_MON_EN;
+	BENCH_DEBUGMON_PRIO = BENCH_IRQ_PRIO;
+	osThreadTerminate(load);
+	bench_stat_print("zlat", "basepri", ZLAT_BASEPRI, &zlat_st);
+#endif
+}
@@ -0,0 +1,43 @@
+#include "bench.h"
+
+void device_init(void)
+{
+}
+
+int main(void)
+{
+	bench_cycles_init();
+	bench_irq_init();
+
+	printf("rtx benchmark\r\n");
+	bench_rdyq();
+	bench_dly();
+	bench_ctxsw();
+	bench_sem();
+	bench_mbox();
+	bench_mbox_batch();
+	bench_egrp();
+	bench_preempt_thr();
+	bench_edf();
+	bench_period();
+	bench_clock();
+	bench_msgbuf();
+	bench_waitany();
+	bench_mutex();
+	bench_lock();
+	bench_isr();
+	bench_isr_burst();
+	bench_zlat();
+	bench_stack();
+	bench_stkcls();
+	bench_trace();
+	printf("done\r\n");
+
+#ifdef TARGET_POSIX
+	/* The host process exits with the status main() returns */
+	return 0;
+#else
+	for (;;)
+		osDelay(osWaitForever);
+#endif
+}
@@ -0,0 +1,260 @@
+#include "common.h"
+#include "cmsis_os.h"
+#include "cmsis_compiler.h"
+#include "driver/device.h"
+#include "driver/hrtimer.h"
+
+/*
+ * Pending timers are kept in a binary min-heap on the expiry time, the
+ * compare channel is always programmed for the root. Expiry times are
+ * compared with a signed difference, so timers can be started at most
+ * 2^31 us (35 minutes) ahead of the counter.
+ */
+static struct hrtimer *hrtimer_heap[CONFIG_HRTIMER_NUM];
+static unsigned int hrtimer_nr;
+
+static struct device *hrtimer_dev;
+static struct hrtimer_ops *hrtimer_ops;
+
+#define hrtimer_before(a, b)	((int32_t)((a) - (b)) < 0)
+
+/* The heap is shared with the timer interrupt and other interrupts */
+static inline uint32_t hrtimer_lock(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	return primask;
+}
+
+static inline void hrtimer_unlock(uint32_t primask)
+{
+	__set_PRIMASK(primask);
+}
+
+static void hrtimer_heap_set(unsigned int i, struct hrtimer *timer)
+{
+	hrtimer_heap[i] = timer;
+	timer->index = i;
+}
+
+static void hrtimer_sift_up(unsigned int i, struct hrtimer *timer)
+{
+	unsigned int parent;
+
+	while (i) {
+		parent = (i - 1) / 2;
+		if (!hrtimer_before(timer->expires,
+				    hrtimer_heap[parent]->expires))
+			break;
+		hrtimer_heap_set(i, hrtimer_heap[parent]);
+		i = parent;
+	}
+	hrtimer_heap_set(i, timer);
+}
+
+static void hrtimer_sift_down(unsigned int i, struct hrtimer *timer)
+{
+	unsigned int child;
+
+	while ((child = 2 * i + 1) < hrtimer_nr) {
+		if (child + 1 < hrtimer_nr &&
+		    hrtimer_before(hrtimer_heap[child + 1]->expires,
+				   hrtimer_heap[child]->expires))
+			child++;
+		if (!hrtimer_before(hrtimer_heap[child]->expires,
+				    timer->expires))
+			break;
+		hrtimer_heap_set(i, hrtimer_heap[child]);
+		i = child;
+	}
+	hrtimer_heap_set(i, timer);
+}
+
+static void hrtimer_remove(struct hrtimer *timer)
+{
+	unsigned int i = timer->index;
+	struct hrtimer *last = hrtimer_heap[--hrtimer_nr];
+
+	timer->index = HRTIMER_IDLE;
+	if (last == timer)
+		return;
+
+	/* The last timer fills the hole and moves whichever way it belongs */
+	if (i && hrtimer_before(last->expires, hrtimer_heap[(i - 1) / 2]->expires))
+		hrtimer_sift_up(i, last);
+	else
+		hrtimer_sift_down(i, last);
+}
+
+/*
+ * Program the compare for the root of the heap. A compare set behind the
+ * counter would only match after the counter wraps, so the counter is
+ * read back and a missed expiry raises the interrupt by hand. Callbacks
+ * always run from the timer interrupt that way.
+ */
+static void hrtimer_program(void)
+{
+	struct hrtimer *timer;
+
+	if (!hrtimer_nr) {
+		hrtimer_ops->stop(hrtimer_dev);
+		return;
+	}
+
+	timer = hrtimer_heap[0];
+	hrtimer_ops->set_next(hrtimer_dev, timer->expires);
+	if (!hrtimer_before(hrtimer_now(), timer->expires))
+		hrtimer_ops->trigger(hrtimer_dev);
+}
+
+void hrtimer_init(struct hrtimer *timer,
+		  void (*function)(struct hrtimer *timer), void *data)
+{
+	timer->expires = 0;
+	timer->function = function;
+	timer->data = data;
+	timer->index = HRTIMER_IDLE;
+}
+
+/**
+ * hrtimer_start - (re)start a timer to expire @us microseconds from now
+ *
+ * Returns 0, or -ENODEV without a clock event driver, -EINVAL for a
+ * timer without a function or too far ahead, -ENOMEM when
+ * CONFIG_HRTIMER_NUM timers are already pending.
+ */
+int hrtimer_start(struct hrtimer *timer, uint32_t us)
+{
+	uint32_t flags;
+	int ret = 0;
+
+	if (!hrtimer_ops)
+		return -ENODEV;
+	if (!timer->function || us > 0x7FFFFFFF)
+		return -EINVAL;
+
+	flags = hrtimer_lock();
+	if (hrtimer_active(timer))
+		hrtimer_remove(timer);
+	if (hrtimer_nr == CONFIG_HRTIMER_NUM) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	timer->expires = hrtimer_now() + us;
+	hrtimer_sift_up(hrtimer_nr++, timer);
+	hrtimer_program();
+out:
+	hrtimer_unlock(flags);
+	return ret;
+}
+
+/**
+ * hrtimer_cancel - remove a pending timer
+ *
+ * Returns 1 when the timer was pending, 0 when it was not.
+ */
+int hrtimer_cancel(struct hrtimer *timer)
+{
+	uint32_t flags;
+	int active;
+
+	flags = hrtimer_lock();
+	active = hrtimer_active(timer);
+	if (active) {
+		hrtimer_remove(timer);
+		hrtimer_program();
+	}
+	hrtimer_unlock(flags);
+	return active;
+}
+
+uint32_t hrtimer_now(void)
+{
+	return hrtimer_ops ? hrtimer_ops->read(hrtimer_dev) : 0;
+}
+
+static void hrtimer_wakeup(struct hrtimer *timer)
+{
+	osSignalSet((osThreadId)timer->data, HRTIMER_SIGNAL);
+}
+
+/* Only a thread with interrupts unmasked may block on the kernel */
+static inline int hrtimer_can_sleep(void)
+{
+	if (__get_IPSR() || __get_PRIMASK() || !osKernelRunning())
+		return 0;
+#if CONFIG_RTX_BASEPRI
+	if (__get_BASEPRI())
+		return 0;
+#endif
+	return 1;
+}
+
+/**
+ * hrtimer_usleep - sleep for @us microseconds
+ *
+ * A thread blocks until a timer wakes it up. Short sleeps, and calls from
+ * interrupts, masked sections or before the kernel runs, spin on the
+ * counter instead.
+ */
+int hrtimer_usleep(uint32_t us)
+{
+	struct hrtimer timer;
+	uint32_t start;
+	int ret;
+
+	if (!hrtimer_ops)
+		return -ENODEV;
+
+	start = hrtimer_now();
+	if (us < HRTIMER_SPIN_US || !hrtimer_can_sleep()) {
+		while (hrtimer_now() - start < us)
+			;
+		return 0;
+	}
+
+	hrtimer_init(&timer, hrtimer_wakeup, osThreadGetId());
+	ret = hrtimer_start(&timer, us);
+	if (ret)
+		return ret;
+
+	/* Another sender of the same flag must not end the sleep early */
+	do {
+		osSignalWait(HRTIMER_SIGNAL, osWaitForever);
+	} while (hrtimer_active(&timer));
+
+	return 0;
+}
+
+/*
+ * Called by the clock event driver on the compare interrupt. The lock is
+ * dropped around each callback, so callbacks may start timers again.
+ */
+void hrtimer_interrupt(void)
+{
+	struct hrtimer *timer;
+	uint32_t flags;
+
+	flags = hrtimer_lock();
+	while (hrtimer_nr) {
+		timer = hrtimer_heap[0];
+		if (hrtimer_before(hrtimer_now(), timer->expires))
+			break;
+		hrtimer_remove(timer);
+		hrtimer_unlock(flags);
+		timer->function(timer);
+		flags = hrtimer_lock();
+	}
+	hrtimer_program();
+	hrtimer_unlock(flags);
+}
+
+void hrtimer_register(struct device *dev, struct hrtimer_ops *ops)
+{
+	if (ops) {
+		hrtimer_dev = dev;
+		hrtimer_ops = ops;
+	}
+}
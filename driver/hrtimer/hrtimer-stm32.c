@@ -0,0 +1,130 @@
+#include "common.h"
+#include "driver/base.h"
+#include "driver/clock.h"
+#include "driver/hrtimer.h"
+#include "driver/irq.h"
+#include "driver/platform.h"
+#include "driver/resource.h"
+#include "asm/io.h"
+#include "asm/arch/base.h"
+#include "asm/arch/clock.h"
+
+/*
+ * Clock event driver on a 32-bit general-purpose timer of APB1, TIM2 or
+ * TIM5. The counter runs free at 1 MHz over the full 32 bits and compare
+ * channel 1 raises the interrupt for the earliest hrtimer.
+ */
+
+struct stm32_tim_regs {
+	uint32_t cr1;		/* TIM control 1 */
+	uint32_t cr2;		/* TIM control 2 */
+	uint32_t smcr;		/* TIM slave mode control */
+	uint32_t dier;		/* TIM DMA/interrupt enable */
+	uint32_t sr;		/* TIM status */
+	uint32_t egr;		/* TIM event generation */
+	uint32_t ccmr1;		/* TIM capture/compare mode 1 */
+	uint32_t ccmr2;		/* TIM capture/compare mode 2 */
+	uint32_t ccer;		/* TIM capture/compare enable */
+	uint32_t cnt;		/* TIM counter */
+	uint32_t psc;		/* TIM prescaler */
+	uint32_t arr;		/* TIM auto-reload */
+	uint32_t rsv0;
+	uint32_t ccr[4];	/* TIM capture/compare 1 - 4 */
+};
+
+#define TIM_CR1_CEN		(1 << 0)
+#define TIM_DIER_CC1IE		(1 << 1)
+#define TIM_SR_CC1IF		(1 << 1)
+#define TIM_EGR_UG		(1 << 0)
+#define TIM_EGR_CC1G		(1 << 1)
+
+#define STM32_HRTIMER_HZ	1000000
+
+static struct stm32_tim_regs *stm32_tim;
+
+static uint32_t stm32_hrtimer_read(struct device *dev)
+{
+	return readl(&stm32_tim->cnt);
+}
+
+static void stm32_hrtimer_set_next(struct device *dev, uint32_t expires)
+{
+	writel(expires, &stm32_tim->ccr[0]);
+	/* The flag is set on every match, also while the interrupt is off */
+	writel(~TIM_SR_CC1IF, &stm32_tim->sr);
+	setbits_le32(&stm32_tim->dier, TIM_DIER_CC1IE);
+}
+
+static void stm32_hrtimer_trigger(struct device *dev)
+{
+	writel(TIM_EGR_CC1G, &stm32_tim->egr);
+}
+
+static void stm32_hrtimer_stop(struct device *dev)
+{
+	clrbits_le32(&stm32_tim->dier, TIM_DIER_CC1IE);
+}
+
+static struct hrtimer_ops stm32_hrtimer_ops = {
+	.read = stm32_hrtimer_read,
+	.set_next = stm32_hrtimer_set_next,
+	.trigger = stm32_hrtimer_trigger,
+	.stop = stm32_hrtimer_stop,
+};
+
+static void stm32_hrtimer_interrupt(void)
+{
+	writel(~TIM_SR_CC1IF, &stm32_tim->sr);
+	hrtimer_interrupt();
+}
+
+static int stm32_hrtimer_probe(struct device *dev)
+{
+	struct platform_device *pdev = to_platform_device(dev);
+	struct resource *io_res, *irq_res;
+	unsigned long rate;
+
+	io_res = platform_get_resource(pdev, RESOURCE_IO, 0);
+	irq_res = platform_get_resource(pdev, RESOURCE_IRQ, 0);
+	if (io_res == NULL || irq_res == NULL)
+		return -ENOENT;
+
+	stm32_tim = (struct stm32_tim_regs *)io_res->start;
+	clk_setup_dev(dev);
+
+	/* APB1 timers run at twice the bus clock when the bus is divided */
+	rate = clk_get(CLOCK_APB1);
+	if (rate != clk_get(CLOCK_AHB))
+		rate *= 2;
+
+	writel(0, &stm32_tim->cr1);
+	writel(0, &stm32_tim->dier);
+	writel(0, &stm32_tim->ccmr1);
+	writel(rate / STM32_HRTIMER_HZ - 1, &stm32_tim->psc);
+	writel(0xFFFFFFFF, &stm32_tim->arr);
+	/* Load the prescaler now rather than at the first wrap */
+	writel(TIM_EGR_UG, &stm32_tim->egr);
+	writel(0, &stm32_tim->sr);
+	writel(TIM_CR1_CEN, &stm32_tim->cr1);
+
+	request_irq(irq_res->start, stm32_hrtimer_interrupt,
+		    irq_res->flags & IRQ_FLAG_MASK);
+	hrtimer_register(dev, &stm32_hrtimer_ops);
+
+	printf("device '%s': %d Hz hrtimer\n", dev->name, STM32_HRTIMER_HZ);
+	return 0;
+}
+
+static struct platform_driver stm32_hrtimer_platform_driver = {
+	.driver = {
+		.name = "stm32-hrtimer",
+		.probe = stm32_hrtimer_probe,
+	},
+};
+
+void stm32_hrtimer_init(void)
+{
+	platform_driver_register(&stm32_hrtimer_platform_driver);
+}
+
+module_init(stm32_hrtimer_init);
@@ -0,0 +1,71 @@
+#ifndef __DRIVER_HRTIMER_H
+#define __DRIVER_HRTIMER_H
+
+#include <stdint.h>
+
+struct device;
+struct hrtimer;
+
+/* Signal flag hrtimer_usleep() waits on, reserved in the sleeping thread */
+#define HRTIMER_SIGNAL		(1 << 15)
+
+/*
+ * Sleeps shorter than this spin on the counter instead of switching, as do
+ * sleeps with PRIMASK set or, under CONFIG_RTX_BASEPRI, BASEPRI raised:
+ * the kernel call would fault and the compare interrupt could not wake them.
+ */
+#define HRTIMER_SPIN_US		10
+
+#define HRTIMER_IDLE		(-1)
+
+/**
+ * struct hrtimer - one-shot high resolution timer
+ *
+ * @expires:	counter value the timer fires at, in microseconds
+ * @function:	called from the timer interrupt when the timer expires
+ * @data:	for the owner of the timer
+ * @index:	slot in the timer heap, HRTIMER_IDLE when not queued
+ *
+ * The timer is owned by the caller and must stay valid while queued.
+ */
+struct hrtimer {
+	uint32_t expires;
+	void (*function)(struct hrtimer *timer);
+	void *data;
+	int index;
+};
+
+/**
+ * struct hrtimer_ops - clock event driver operations
+ *
+ * The counter is free-running over 32 bits at 1 MHz.
+ *
+ * read() returns the counter. set_next() programs the compare match for
+ * @expires and enables its interrupt, trigger() raises the interrupt at
+ * once and stop() disables it. The interrupt handler of the driver calls
+ * hrtimer_interrupt().
+ */
+struct hrtimer_ops {
+	uint32_t (*read) (struct device *dev);
+	void (*set_next) (struct device *dev, uint32_t expires);
+	void (*trigger) (struct device *dev);
+	void (*stop) (struct device *dev);
+};
+
+void hrtimer_register(struct device *dev, struct hrtimer_ops *ops);
+void hrtimer_interrupt(void);
+
+/* user call */
+void hrtimer_init(struct hrtimer *timer,
+		  void (*function)(struct hrtimer *timer), void *data);
+int hrtimer_start(struct hrtimer *timer, uint32_t us);
+int hrtimer_cancel(struct hrtimer *timer);
+uint32_t hrtimer_now(void);
+int hrtimer_usleep(uint32_t us);
+
+static inline int hrtimer_active(struct hrtimer *timer)
+{
+	return timer->index != HRTIMER_IDLE;
+}
+
+#endif	/* __DRIVER_HRTIMER_H */
@@ -2,20 +2,80 @@
 #define __DRIVER_TIME_H
 
 #include "cmsis_os.h"
+#include "asm/arch/base.h"
+#if CONFIG_HRTIMER
+#include "driver/hrtimer.h"
+#endif
 
 
 #define get_timer()		osKernelSysTick()
 #define mdelay(x)		osDelay(x)
 
+/* From this long on udelay() gives the cpu to other threads */
+#define UDELAY_SLEEP_US		50
+/* Longest wait the 32-bit cycle counter can measure in one go */
+#define UDELAY_MAX_US		(0x7FFFFFFFUL / (CONFIG_SYS_CLK_FREQ / 1000000))
+
+/*
+ * Busy wait on the DWT cycle counter. It counts core clocks, so the delay
+ * does not depend on flash wait states or the optimisation level.
+ */
+static inline void __udelay(uint32_t time)
+{
+	uint32_t start = DWT->CYCCNT;
+	uint32_t cycles = time * (CONFIG_SYS_CLK_FREQ / 1000000);
+
+	while (DWT->CYCCNT - start < cycles)
+		;
+}
+
+/* Only a thread with interrupts unmasked may block on the kernel */
+static inline int udelay_can_sleep(void)
+{
+	if (__get_IPSR() || __get_PRIMASK() || !osKernelRunning())
+		return 0;
+#if CONFIG_RTX_BASEPRI
+	if (__get_BASEPRI())
+		return 0;
+#endif
+	return 1;
+}
+
 /*
- * for loop need at least 2 assembly codes: add and compare, so we use
- * CONFIG_SYS_CLK_FREQ / 2MHz times for 1us
+ * A thread waiting UDELAY_SLEEP_US or more sleeps on an hrtimer when
+ * there is one, or else on the system tick for all but the last tick of
+ * the delay and spins for the rest. Interrupts, sections with interrupts
+ * masked and code running before the kernel always spin.
  */
 static inline void udelay(uint32_t time)
 {
-	while (time--) {
-		for (uint8_t i = 0; i < CONFIG_SYS_CLK_FREQ / 2000000; i++);
+	uint32_t start, ms;
+
+	if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 	}
+
+	for (; time > UDELAY_MAX_US; time -= UDELAY_MAX_US)
+		__udelay(UDELAY_MAX_US);
+
+	start = DWT->CYCCNT;
+	if (time >= UDELAY_SLEEP_US && udelay_can_sleep()) {
+#if CONFIG_HRTIMER
+		if (!hrtimer_usleep(time))
+			return;
+#endif
+		/* osDelay() may run up to a tick long, so leave one out */
+		if (time >= 2 * CONFIG_SYS_HZ) {
+			ms = (time - CONFIG_SYS_HZ) / 1000;
+			osDelay(ms);
+		}
+	}
+
+	/* Spin for what the sleep left over */
+	time *= CONFIG_SYS_CLK_FREQ / 1000000;
+	while (DWT->CYCCNT - start < time)
+		;
 }
 
 #endif
@@ -45,6 +45,11 @@
 BIT dbg_msg;
 #endif
 
+/* The context switch in HAL_CM*.S reaches into the TCB at fixed offsets:  */
+/* a mismatch with the structure gives a negative array size here.         */
+typedef U8 rt_tcb_stackf[(offsetof (struct OS_TCB, stack_frame) == TCB_STACKF) ? 1 : -1];
+typedef U8 rt_tcb_tstack[(offsetof (struct OS_TCB, tsk_stack)   == TCB_TSTACK) ? 1 : -1];
+
 /*----------------------------------------------------------------------------
  *      Functions
  *---------------------------------------------------------------------------*/
@@ -109,6 +114,33 @@ void rt_init_stack (P_TCB p_TCB, FUNCP task_body) {
 }
 
 
+#ifdef CONFIG_RTX_STK_WATERMARK
+/* Main stack bounds, from the linker script */
+extern U32 __StackLimit[], __StackTop[];
+
+/*--------------------------- rt_msp_area -----------------------------------*/
+
+U32 *rt_msp_area (U32 *words) {
+  /* Return the bottom of the main stack and its size in words. */
+  *words = (U32)(__StackTop - __StackLimit);
+  return (__StackLimit);
+}
+
+
+/*--------------------------- rt_msp_fill -----------------------------------*/
+
+void rt_msp_fill (void) {
+  /* Fill the main stack below the current frame with magic pattern. */
+  U32 mark;
+  U32 *stk;
+
+  for (stk = &mark - 16; stk >= __StackLimit; stk--) {
+    *stk = MAGIC_PATTERN;
+  }
+}
+#endif
+
+
 /*--------------------------- rt_ret_val ----------------------------------*/
 
 static __inline U32 *rt_ret_regs (P_TCB p_TCB) {
@@ -52,7 +52,48 @@
 #define _declare_box(pool,size,cnt)  uint32_t pool[(((size)+3)/4)*(cnt) + 3]
 #define _declare_box8(pool,size,cnt) uint64_t pool[(((size)+7)/8)*(cnt) + 2]
 
-#define OS_TCB_SIZE     52
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+#define OS_TCB_RDYQ     8
+#else
+#define OS_TCB_RDYQ     0
+#endif
+#ifdef CONFIG_RTX_CPU_STAT
+#define OS_TCB_CPU      12
+#else
+#define OS_TCB_CPU      0
+#endif
+#ifdef CONFIG_RTX_STK_WATERMARK
+#define OS_TCB_STK      4
+#else
+#define OS_TCB_STK      0
+#endif
+#ifdef CONFIG_RTX_PSQ_COALESCE
+#define OS_TCB_PSQ      4
+#else
+#define OS_TCB_PSQ      0
+#endif
+#ifdef CONFIG_RTX_PREEMPT_THR
+#define OS_TCB_THR      4
+#else
+#define OS_TCB_THR      0
+#endif
+#ifdef CONFIG_RTX_ROBIN_SLICE
+#define OS_TCB_RBN      4
+#else
+#define OS_TCB_RBN      0
+#endif
+#ifdef CONFIG_RTX_EDF
+#define OS_TCB_EDF      20
+#else
+#define OS_TCB_EDF      0
+#endif
+#ifdef CONFIG_RTX_FAST_SYNC
+#define OS_TCB_FAST     4
+#else
+#define OS_TCB_FAST     0
+#endif
+#define OS_TCB_SIZE     (56+OS_TCB_RDYQ+OS_TCB_CPU+OS_TCB_STK+OS_TCB_PSQ+ \
+                         OS_TCB_THR+OS_TCB_RBN+OS_TCB_EDF+OS_TCB_FAST)
 #define OS_TMR_SIZE     8
 
 #if (( defined(__CC_ARM)                                          || \
@@ -66,20 +107,20 @@ typedef uint32_t OS_RESULT;
 
 #define runtask_id()    rt_tsk_self()
 #define mutex_init(m)   rt_mut_init(m)
-#define mutex_wait(m)   os_mut_wait(m,0xFFFFU)
+#define mutex_wait(m)   os_mut_wait(m,0xFFFFFFFFU)
 #define mutex_rel(m)    os_mut_release(m)
 
 extern uint8_t   os_running;
 extern OS_TID    rt_tsk_self    (void);
 extern void      rt_mut_init    (OS_ID mutex);
 extern OS_RESULT rt_mut_release (OS_ID mutex);
-extern OS_RESULT rt_mut_wait    (OS_ID mutex, uint16_t timeout);
+extern OS_RESULT rt_mut_wait    (OS_ID mutex, uint32_t timeout);
 
 #if defined(__CC_ARM)
 #define os_mut_wait(mutex,timeout) _os_mut_wait((uint32_t)rt_mut_wait,mutex,timeout)
 #define os_mut_release(mutex)      _os_mut_release((uint32_t)rt_mut_release,mutex)
 OS_RESULT _os_mut_release (uint32_t p, OS_ID mutex)                   __svc_indirect(0);
-OS_RESULT _os_mut_wait    (uint32_t p, OS_ID mutex, uint16_t timeout) __svc_indirect(0);
+OS_RESULT _os_mut_wait    (uint32_t p, OS_ID mutex, uint32_t timeout) __svc_indirect(0);
 #else
 __attribute__((always_inline))
 static __inline OS_RESULT os_mut_release (OS_ID mutex) {
@@ -98,7 +139,7 @@ static __inline OS_RESULT os_mut_release (OS_ID mutex) {
   return (OS_RESULT)__r0;
 }
 __attribute__((always_inline))
-static __inline OS_RESULT os_mut_wait (OS_ID mutex, uint16_t timeout) {
+static __inline OS_RESULT os_mut_wait (OS_ID mutex, uint32_t timeout) {
   register uint32_t __r0 __asm("r0") = (uint32_t)mutex;
   register uint32_t __r1 __asm("r1") = (uint32_t)timeout;
   register uint32_t __r2 __asm("r2");
@@ -126,10 +167,26 @@ static __inline OS_RESULT os_mut_wait (OS_ID mutex, uint16_t timeout) {
 #error "Invalid number of concurrent running threads!"
 #endif
 
-#if (OS_PRIVCNT >= OS_TASKCNT)
+#ifdef CONFIG_RTX_STK_POOLS
+#define OS_STKCLS_CNT (OS_STKCLS0_CNT+OS_STKCLS1_CNT+OS_STKCLS2_CNT+OS_STKCLS3_CNT)
+#else
+#define OS_STKCLS_CNT 0
+#endif
+
+#if ((OS_PRIVCNT+OS_STKCLS_CNT) >= OS_TASKCNT)
 #error "Too many threads with user-provided stack size!"
 #endif
 
+#ifdef CONFIG_RTX_STK_POOLS
+#if ((OS_STKCLS0_SIZE & 7) || (OS_STKCLS1_SIZE & 7) || (OS_STKCLS2_SIZE & 7) || (OS_STKCLS3_SIZE & 7))
+#error "Stack size class block sizes must be multiples of 8 bytes!"
+#endif
+#if ((OS_STKCLS0_SIZE > OS_STKCLS1_SIZE) || (OS_STKCLS1_SIZE > OS_STKCLS2_SIZE) || \
+     (OS_STKCLS2_SIZE > OS_STKCLS3_SIZE) || (OS_STKCLS3_SIZE > 65535))
+#error "Stack size classes must ascend and stay below 64 KB!"
+#endif
+#endif
+
 #if (OS_TIMERS != 0)
 #define OS_TASK_CNT (OS_TASKCNT + 1)
 #define OS_PRIV_CNT (OS_PRIVCNT + 2)
@@ -180,11 +237,40 @@ uint16_t const mp_tcb_size = sizeof(mp_tcb);
 /* Memory pool for System stack allocation (+os_idle_demon). */
 extern
 uint64_t       mp_stk[];
-_declare_box8 (mp_stk, OS_STKSIZE*4, OS_TASK_CNT-OS_PRIV_CNT+1);
+_declare_box8 (mp_stk, OS_STKSIZE*4, OS_TASK_CNT-OS_PRIV_CNT-OS_STKCLS_CNT+1);
 extern
 uint32_t const mp_stk_size;
 uint32_t const mp_stk_size = sizeof(mp_stk);
 
+#ifdef CONFIG_RTX_STK_POOLS
+/* Memory pools for user specified stack sizes, one per size class */
+extern
+uint64_t       mp_stkcls0[];
+_declare_box8 (mp_stkcls0, OS_STKCLS0_SIZE, OS_STKCLS0_CNT);
+extern
+uint64_t       mp_stkcls1[];
+_declare_box8 (mp_stkcls1, OS_STKCLS1_SIZE, OS_STKCLS1_CNT);
+extern
+uint64_t       mp_stkcls2[];
+_declare_box8 (mp_stkcls2, OS_STKCLS2_SIZE, OS_STKCLS2_CNT);
+extern
+uint64_t       mp_stkcls3[];
+_declare_box8 (mp_stkcls3, OS_STKCLS3_SIZE, OS_STKCLS3_CNT);
+extern
+void    *const os_stkcls_pool[];
+void    *const os_stkcls_pool[] = { mp_stkcls0, mp_stkcls1, mp_stkcls2, mp_stkcls3 };
+extern
+uint32_t const os_stkcls_psz[];
+uint32_t const os_stkcls_psz[]  = { sizeof(mp_stkcls0), sizeof(mp_stkcls1),
+                                    sizeof(mp_stkcls2), sizeof(mp_stkcls3) };
+extern
+uint32_t const os_stkcls_info[];
+uint32_t const os_stkcls_info[] = { (OS_STKCLS0_CNT<<16) | OS_STKCLS0_SIZE,
+                                    (OS_STKCLS1_CNT<<16) | OS_STKCLS1_SIZE,
+                                    (OS_STKCLS2_CNT<<16) | OS_STKCLS2_SIZE,
+                                    (OS_STKCLS3_CNT<<16) | OS_STKCLS3_SIZE };
+#endif
+
 /* Memory pool for user specified stack allocation (+main, +timer) */
 extern
 uint64_t       os_stack_mem[];
@@ -196,14 +282,17 @@ uint32_t const os_stack_sz = sizeof(os_stack_mem);
 #ifndef OS_FIFOSZ
 #define OS_FIFOSZ       16
 #endif
+#if (OS_FIFOSZ > 65535)
+#error "ISR FIFO Queue size (OS_FIFOSZ) exceeds 65535 entries"
+#endif
 
 /* Fifo Queue buffer for ISR requests.*/
 extern
 uint32_t       os_fifo[];
-uint32_t       os_fifo[OS_FIFOSZ*2+1];
+uint32_t       os_fifo[OS_FIFOSZ*2+2];
 extern
-uint8_t  const os_fifo_size;
-uint8_t  const os_fifo_size = OS_FIFOSZ;
+uint16_t const os_fifo_size;
+uint16_t const os_fifo_size = OS_FIFOSZ;
 
 /* An array of Active task pointers. */
 extern
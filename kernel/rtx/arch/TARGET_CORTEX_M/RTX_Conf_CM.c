@@ -81,6 +81,44 @@
  #define OS_PRIVSTKSIZE 0       // this stack size value is in words
 #endif
  
+//   <h>Stack size classes (CONFIG_RTX_STK_POOLS)
+//   <i> Threads with user-provided stack size take the smallest block that fits
+//   <i> from these pools, before the user-provided stack area. Block sizes must
+//   <i> ascend, blocks count as threads with user-provided stack size.
+//     <o>Class 0 block size [bytes] <8-65528:8>
+#ifndef OS_STKCLS0_SIZE
+ #define OS_STKCLS0_SIZE 256
+#endif
+//     <o>Class 0 blocks <0-250>
+#ifndef OS_STKCLS0_CNT
+ #define OS_STKCLS0_CNT  2
+#endif
+//     <o>Class 1 block size [bytes] <8-65528:8>
+#ifndef OS_STKCLS1_SIZE
+ #define OS_STKCLS1_SIZE 512
+#endif
+//     <o>Class 1 blocks <0-250>
+#ifndef OS_STKCLS1_CNT
+ #define OS_STKCLS1_CNT  0
+#endif
+//     <o>Class 2 block size [bytes] <8-65528:8>
+#ifndef OS_STKCLS2_SIZE
+ #define OS_STKCLS2_SIZE 1024
+#endif
+//     <o>Class 2 blocks <0-250>
+#ifndef OS_STKCLS2_CNT
+ #define OS_STKCLS2_CNT  0
+#endif
+//     <o>Class 3 block size [bytes] <8-65528:8>
+#ifndef OS_STKCLS3_SIZE
+ #define OS_STKCLS3_SIZE 2048
+#endif
+//     <o>Class 3 blocks <0-250>
+#ifndef OS_STKCLS3_CNT
+ #define OS_STKCLS3_CNT  1
+#endif
+//   </h>
+ 
 //   <q>Stack overflow checking
 //   <i> Enable stack overflow checks at thread switch.
 //   <i> Enabling this option increases slightly the execution time of a thread switch.
@@ -94,6 +132,11 @@
 #ifndef OS_STKINIT
 #define OS_STKINIT      0
 #endif
+#ifdef CONFIG_RTX_STK_WATERMARK
+// Stack high water marks are read back from the pattern
+#undef  OS_STKINIT
+#define OS_STKINIT      1
+#endif
  
 //   <o>Processor mode for thread execution 
 //     <0=> Unprivileged mode 
@@ -190,9 +233,13 @@
 //                         <12=> 12 entries  <16=> 16 entries
 //                         <24=> 24 entries  <32=> 32 entries
 //                         <48=> 48 entries  <64=> 64 entries
-//                         <96=> 96 entries
+//                         <96=> 96 entries <128=> 128 entries
+//                         <256=> 256 entries <512=> 512 entries
+//                         <1024=> 1024 entries
 //   <i> ISR functions store requests to this buffer,
 //   <i> when they are called from the interrupt handler.
+//   <i> With CONFIG_RTX_PSQ_COALESCE a semaphore or thread
+//   <i> takes at most one entry however often it is posted.
 //   <i> Default: 16 entries
 #ifndef OS_FIFOSZ
  #define OS_FIFOSZ      16
@@ -223,11 +270,28 @@
  
 /*--------------------------- os_idle_demon ---------------------------------*/
 
+#ifdef CONFIG_RTX_TICKLESS
+extern uint32_t os_tick_sleep (uint32_t ticks);
+#endif
+
 /// \brief The idle demon is running when no other thread is ready to run
 void os_idle_demon (void) {
+#ifdef CONFIG_RTX_TICKLESS
+  uint32_t sleep;
+#endif
  
   for (;;) {
     /* HERE: include optional user code to be executed when no thread runs.*/
+#ifdef CONFIG_RTX_STK_WATERMARK
+    /* Move the stack watermark scan on by a few words. */
+    os_stack_scan();
+#endif
+#ifdef CONFIG_RTX_TICKLESS
+    /* Stop the tick until the next timeout is due, then catch up. */
+    sleep = os_suspend();
+    sleep = os_tick_sleep(sleep);
+    os_resume(sleep);
+#endif
   }
 }
  
@@ -266,6 +330,19 @@ void os_tick_irqack (void) {
   /* ... */
 }
  
+/*--------------------------- os_tick_sleep ---------------------------------*/
+ 
+/// \brief Sleep with alternative hardware timer as one-shot (tickless idle)
+/// \param[in]   ticks      number of ticks until the next kernel timeout
+/// \return                 number of ticks elapsed while sleeping
+uint32_t os_tick_sleep (uint32_t ticks) {
+  /* Called with interrupts enabled and the timer interrupt locked. Program */
+  /* the timer to expire "ticks" away (a 32-bit timer such as TIM2/TIM5 on  */
+  /* STM32 covers any sleep), wait for an interrupt, then restart periodic  */
+  /* ticks in phase and return the ticks elapsed. 0 means not slept.        */
+  return (0);
+}
+ 
 #endif   // (OS_SYSTICK == 0)
  
 /*--------------------------- os_error --------------------------------------*/
@@ -40,6 +40,8 @@
   #include "core_cm3.h"
 #elif defined (__CORTEX_M0)
   #include "core_cm0.h"
+#elif defined (TARGET_POSIX)
+  /* Core registers are emulated by rt_HAL_CM.h of the host port */
 #else
   #error "Missing __CORTEX_Mx definition"
 #endif
@@ -51,12 +53,22 @@
 #include "rt_Event.h"
 #include "rt_List.h"
 #include "rt_Time.h"
+#include "rt_Robin.h"
 #include "rt_Mutex.h"
 #include "rt_Semaphore.h"
 #include "rt_Mailbox.h"
 #include "rt_MemBox.h"
 #include "rt_Memory.h"
+#include "rt_MsgBuf.h"
+#include "rt_EvtGroup.h"
+#include "rt_Trace.h"
+#include "rt_Wait.h"
+#include "rt_Edf.h"
+#if defined (TARGET_POSIX)
+#include <rt_HAL_CM.h>                  // HAL of the host port, not the one next to this file
+#else
 #include "rt_HAL_CM.h"
+#endif
 
 #define os_thread_cb OS_TCB
 
@@ -142,6 +154,115 @@ static __inline   t __##f (t1 a1, t2 a2, t3 a3, t4 a4) {                       \
 #define SVC_1_3 SVC_1_1 
 #define SVC_2_3 SVC_2_1 
 
+#elif defined (TARGET_POSIX)      /* POSIX host port */
+
+#define __NO_RETURN __attribute__((noreturn))
+
+typedef struct { uint32_t v[2]; } ret64;
+typedef struct { uint32_t v[4]; } ret128;
+
+// Service calls run in place between rt_svc_enter and rt_svc_exit. Results
+// go to the R0-R2 slots of the caller frame, where rt_ret_val() updates
+// them while the caller waits, and are read back after the switch.
+
+#define RET_pointer    __rr[0]
+#define RET_int32_t    __rr[0]
+#define RET_uint32_t   __rr[0]
+#define RET_osStatus   __rr[0]
+#define RET_osPriority __rr[0]
+#define RET_osEvent    {(osStatus)__rr[0], {(uint32_t)__rr[1]}, {(void *)__rr[2]}}
+#define RET_osCallback {(void *)__rr[0], (void *)__rr[1]}
+
+#define osEvent_type       ret128
+#define osEvent_ret_status (ret128){{ret.status}}
+#define osEvent_ret_value  (ret128){{ret.status, ret.value.v}}
+#define osEvent_ret_msg    (ret128){{ret.status, ret.value.v, (uint32_t)ret.def.message_id}}
+#define osEvent_ret_mail   (ret128){{ret.status, ret.value.v, (uint32_t)ret.def.mail_id}}
+
+#define osCallback_type    ret64
+#define osCallback_ret     (ret64) {{(uint32_t)ret.fp, (uint32_t)ret.arg}}
+
+#define SVC_Call(r)                                                            \
+  uint32_t *__rr = rt_svc_enter();                                             \
+  r;                                                                           \
+  rt_svc_exit();
+
+#define SVC_RetN(n,r)                                                          \
+  { __typeof__(r) __r = r; uint32_t __i;                                       \
+    for (__i = 0U; __i < n; __i++) { __rr[__i] = __r.v[__i]; } }
+
+#define SVC_0_1(f,t,rv)                                                        \
+t f (void);                                                                    \
+__attribute__((always_inline))                                                 \
+static inline  t __##f (void) {                                                \
+  SVC_Call(__rr[0] = (uint32_t)f());                                           \
+  return (t) rv;                                                               \
+}
+
+#define SVC_1_0(f,t,t1)                                                        \
+t f (t1 a1);                                                                   \
+__attribute__((always_inline))                                                 \
+static inline  t __##f (t1 a1) {                                               \
+  SVC_Call(f(a1));                                                             \
+  (void)__rr;                                                                  \
+}
+
+#define SVC_1_1(f,t,t1,rv)                                                     \
+t f (t1 a1);                                                                   \
+__attribute__((always_inline))                                                 \
+static inline  t __##f (t1 a1) {                                               \
+  SVC_Call(__rr[0] = (uint32_t)f(a1));                                         \
+  return (t) rv;                                                               \
+}
+
+#define SVC_2_1(f,t,t1,t2,rv)                                                  \
+t f (t1 a1, t2 a2);                                                            \
+__attribute__((always_inline))                                                 \
+static inline  t __##f (t1 a1, t2 a2) {                                        \
+  SVC_Call(__rr[0] = (uint32_t)f(a1,a2));                                      \
+  return (t) rv;                                                               \
+}
+
+#define SVC_3_1(f,t,t1,t2,t3,rv)                                               \
+t f (t1 a1, t2 a2, t3 a3);                                                     \
+__attribute__((always_inline))                                                 \
+static inline  t __##f (t1 a1, t2 a2, t3 a3) {                                 \
+  SVC_Call(__rr[0] = (uint32_t)f(a1,a2,a3));                                   \
+  return (t) rv;                                                               \
+}
+
+#define SVC_4_1(f,t,t1,t2,t3,t4,rv)                                            \
+t f (t1 a1, t2 a2, t3 a3, t4 a4);                                              \
+__attribute__((always_inline))                                                 \
+static inline  t __##f (t1 a1, t2 a2, t3 a3, t4 a4) {                          \
+  SVC_Call(__rr[0] = (uint32_t)f(a1,a2,a3,a4));                                \
+  return (t) rv;                                                               \
+}
+
+#define SVC_1_2(f,t,t1,rv)                                                     \
+osCallback_type f (t1 a1);                                                     \
+__attribute__((always_inline))                                                 \
+static inline  t __##f (t1 a1) {                                               \
+  SVC_Call(SVC_RetN(2U,f(a1)));                                                \
+  return (t) rv;                                                               \
+}
+
+#define SVC_1_3(f,t,t1,rv)                                                     \
+osEvent_type f (t1 a1);                                                        \
+__attribute__((always_inline))                                                 \
+static inline  t __##f (t1 a1) {                                               \
+  SVC_Call(SVC_RetN(3U,f(a1)));                                                \
+  return (t) rv;                                                               \
+}
+
+#define SVC_2_3(f,t,t1,t2,rv)                                                  \
+osEvent_type f (t1 a1, t2 a2);                                                 \
+__attribute__((always_inline))                                                 \
+static inline  t __##f (t1 a1, t2 a2) {                                        \
+  SVC_Call(SVC_RetN(3U,f(a1,a2)));                                             \
+  return (t) rv;                                                               \
+}
+
 #elif defined (__GNUC__)        /* GNU Compiler */
 
 #define __NO_RETURN __attribute__((noreturn))
@@ -211,7 +332,7 @@ typedef uint32_t __attribute__((vector_size(16))) ret128;
     "svc 0"                                                                    \
     :               "=r" (__r0), "=r" (__r1), "=r" (__r2), "=r" (__r3)         \
     :                "r" (__r0),  "r" (__r1),  "r" (__r2),  "r" (__r3)         \
-    : "r7", "r12", "lr", "cc"                                                  \
+    : "r7", "r12", "lr", "cc", "memory"                                        \
   );
 #else
 #define SVC_Call(f)                                                            \
@@ -221,7 +342,7 @@ typedef uint32_t __attribute__((vector_size(16))) ret128;
     "svc 0"                                                                    \
     :               "=r" (__r0), "=r" (__r1), "=r" (__r2), "=r" (__r3)         \
     :                "r" (__r0),  "r" (__r1),  "r" (__r2),  "r" (__r3)         \
-    : "r12", "lr", "cc"                                                        \
+    : "r12", "lr", "cc", "memory"                                              \
   );
 #endif
 
@@ -414,6 +535,9 @@ extern const uint32_t  os_section_id$$Limit;
 extern       uint64_t  os_stack_mem[];
 extern const uint32_t  os_stack_sz;
 
+// Main Thread definition
+extern const osThreadDef_t   os_thread_def_main;
+
 // OS Timers external resources
 extern const osThreadDef_t   os_thread_def_osTimerThread;
 extern       osThreadId      osThreadId_osTimerThread;
@@ -424,17 +548,16 @@ extern       osMessageQId    osMessageQId_osTimerMessageQ;
 // ==== Helper Functions ====
 
 /// Convert timeout in millisec to system ticks
-static uint16_t rt_ms2tick (uint32_t millisec) {
-  uint32_t tick;
+static uint32_t rt_ms2tick (uint32_t millisec) {
+  uint64_t tick;
 
   if (millisec == 0U) { return 0x0U; }                  // No timeout
-  if (millisec == osWaitForever) { return 0xFFFFU; }    // Indefinite timeout
-  if (millisec > 4000000U) { return 0xFFFEU; }          // Max ticks supported
+  if (millisec == osWaitForever) { return 0xFFFFFFFFU; }// Indefinite timeout
 
-  tick = ((1000U * millisec) + os_clockrate - 1U)  / os_clockrate;
-  if (tick > 0xFFFEU) { return 0xFFFEU; }
-  
-  return (uint16_t)tick;
+  tick = ((1000U * (uint64_t)millisec) + os_clockrate - 1U)  / os_clockrate;
+  if (tick > 0xFFFFFFFEU) { return 0xFFFFFFFEU; }       // Max ticks supported
+
+  return (uint32_t)tick;
 }
 
 /// Convert Thread ID to TCB pointer
@@ -487,6 +610,9 @@ SVC_0_1(svcKernelRunning,    int32_t,  RET_int32_t)
 SVC_0_1(svcKernelSysTick,    uint32_t, RET_uint32_t)
 
 static void  sysThreadError   (osStatus status);
+#ifdef CONFIG_RTX_STK_POOLS
+static uint32_t sysStackInit  (void);
+#endif
 osThreadId   svcThreadCreate  (const osThreadDef_t *thread_def, void *argument);
 osMessageQId svcMessageCreate (const osMessageQDef_t *queue_def, osThreadId thread_id);
 
@@ -502,6 +628,10 @@ osStatus svcKernelInitialize (void) {
     if (((uint32_t)os_stack_mem & 7U) != 0U) { return osErrorNoMemory; }
     ret = rt_init_mem(os_stack_mem, os_stack_sz);
     if (ret != 0U) { return osErrorNoMemory; }
+#ifdef CONFIG_RTX_STK_POOLS
+    ret = sysStackInit();
+    if (ret != 0U) { return osErrorNoMemory; }
+#endif
 
     rt_sys_init();                              // RTX System Initialization
   }
@@ -628,6 +758,23 @@ uint32_t osKernelSysTick (void) {
   return __svcKernelSysTick();
 }
 
+#ifdef CONFIG_RTX_CLOCK64
+/// Get the 64-bit RTOS kernel clock
+uint64_t osKernelSysTick64 (void) {
+  return rt_clk_get();                          // Lock-free, no service call
+}
+
+/// Get the 64-bit RTOS kernel clock in nanoseconds
+uint64_t osKernelNanoSec (void) {
+  uint64_t clk;
+
+  clk = rt_clk_get();
+  // Whole seconds and the rest apart, the product does not overflow
+  return ((clk / os_tickfreq) * 1000000000U) +
+         (((clk % os_tickfreq) * 1000000000U) / os_tickfreq);
+}
+#endif
+
 
 // ==== Thread Management ====
 
@@ -636,23 +783,109 @@ static void sysThreadError (osStatus status) {
   // To Do
 }
 
+#ifdef CONFIG_RTX_STK_POOLS
+
+// Stack size class pools use
+static struct OS_STKCLS os_stkcls[OS_STKCLS_NUM];
+
+/// Initialize the stack size class pools
+static uint32_t sysStackInit (void) {
+  uint32_t cls;
+
+  for (cls = 0U; cls < OS_STKCLS_NUM; cls++) {
+    os_stkcls[cls].used = 0U;
+    os_stkcls[cls].peak = 0U;
+    os_stkcls[cls].miss = 0U;
+    if ((os_stkcls_info[cls] >> 16) == 0U) { continue; }        // Class not used
+    if (rt_init_box(os_stkcls_pool[cls], os_stkcls_psz[cls],
+                   BOX_ALIGN_8 | (uint16_t)os_stkcls_info[cls]) != 0U) {
+      return 1U;
+    }
+  }
+  return 0U;
+}
+
+/// Allocate a thread stack from the smallest class that fits and has a block left
+static void *sysStackAlloc (const osThreadDef_t *thread_def, uint32_t *size) {
+  void    *stk;
+  uint32_t cls, miss;
+
+  if ((thread_def == &os_thread_def_main) ||
+      (thread_def == &os_thread_def_osTimerThread)) {
+    // Planned for in the user-provided stack area
+    return rt_alloc_mem(os_stack_mem, *size);
+  }
+
+  miss = 0U;
+  for (cls = 0U; cls < OS_STKCLS_NUM; cls++) {
+    if ((os_stkcls_info[cls] >> 16) == 0U)    { continue; }     // Class not used
+    if ((uint16_t)os_stkcls_info[cls] < *size) { continue; }     // Too small
+    stk = rt_alloc_box(os_stkcls_pool[cls]);
+    if (stk != NULL) {
+      *size = (uint16_t)os_stkcls_info[cls];     // Thread gets the whole block
+      if (++os_stkcls[cls].used > os_stkcls[cls].peak) {
+        os_stkcls[cls].peak = os_stkcls[cls].used;
+      }
+      return stk;
+    }
+    if (miss == 0U) {                            // Smallest fitting class used up
+      os_stkcls[cls].miss++;
+      miss = 1U;
+    }
+  }
+#ifdef CONFIG_RTX_STK_POOLS_HEAP
+  return rt_alloc_mem(os_stack_mem, *size);
+#else
+  return NULL;
+#endif
+}
+
+/// Free a thread stack to its class or to the user-provided stack area
+static void sysStackFree (void *stk) {
+  uint32_t cls;
+
+  for (cls = 0U; cls < OS_STKCLS_NUM; cls++) {
+    if ((os_stkcls_info[cls] >> 16) == 0U) { continue; }        // Class not used
+    if (rt_free_box(os_stkcls_pool[cls], stk) == 0U) {
+      os_stkcls[cls].used--;
+      return;
+    }
+  }
+  rt_free_mem(os_stack_mem, stk);
+}
+
+#else
+
+#define sysStackAlloc(def,size) rt_alloc_mem(os_stack_mem, *(size))
+#define sysStackFree(stk)       (void)rt_free_mem(os_stack_mem, stk)
+
+#endif
+
 __NO_RETURN void osThreadExit (void);
 
 // Thread Service Calls declarations
 SVC_2_1(svcThreadCreate,      osThreadId, const osThreadDef_t *, void *,     RET_pointer)
+#ifdef CONFIG_RTX_PREEMPT_THR
+SVC_3_1(svcThreadCreateEx,    osThreadId, const osThreadDef_t *, void *, osPriority, RET_pointer)
+#endif
 SVC_0_1(svcThreadGetId,       osThreadId,                                    RET_pointer)
 SVC_1_1(svcThreadTerminate,   osStatus,         osThreadId,                  RET_osStatus)
 SVC_0_1(svcThreadYield,       osStatus,                                      RET_osStatus)
 SVC_2_1(svcThreadSetPriority, osStatus,         osThreadId,      osPriority, RET_osStatus)
 SVC_1_1(svcThreadGetPriority, osPriority,       osThreadId,                  RET_osPriority)
+#ifdef CONFIG_RTX_ROBIN_SLICE
+SVC_2_1(svcThreadSetSlice,    osStatus,         osThreadId,      uint32_t,   RET_osStatus)
+SVC_2_1(svcRoundRobinSet,     osStatus,         osPriority,      uint32_t,   RET_osStatus)
+#endif
 
 // Thread Service Calls
 
 /// Create a thread and add it to Active Threads and set it to state READY
 osThreadId svcThreadCreate (const osThreadDef_t *thread_def, void *argument) {
-  P_TCB  ptcb;
-  OS_TID tsk;
-  void  *stk;
+  P_TCB    ptcb;
+  OS_TID   tsk;
+  void    *stk;
+  uint32_t size;
 
   if ((thread_def == NULL) ||
       (thread_def->pthread == NULL) ||
@@ -662,11 +895,9 @@ osThreadId svcThreadCreate (const osThreadDef_t *thread_def, void *argument) {
     return NULL; 
   }
 
-  if (thread_def->stacksize != 0U) {            // Custom stack size
-    stk = rt_alloc_mem(                         // Allocate stack
-      os_stack_mem,
-      thread_def->stacksize
-    );
+  size = thread_def->stacksize;
+  if (size != 0U) {                             // Custom stack size
+    stk = sysStackAlloc(thread_def, &size);     // Allocate stack
     if (stk == NULL) { 
       sysThreadError(osErrorNoMemory);          // Out of memory
       return NULL;
@@ -679,14 +910,14 @@ osThreadId svcThreadCreate (const osThreadDef_t *thread_def, void *argument) {
     (FUNCP)thread_def->pthread,                 // Task function pointer
     (uint32_t)
     (thread_def->tpriority-osPriorityIdle+1) |  // Task priority
-    (thread_def->stacksize << 8),               // Task stack size in bytes
+    (size << 8),                                // Task stack size in bytes
     stk,                                        // Pointer to task's stack
     argument                                    // Argument to the task
   );
 
   if (tsk == 0U) {                              // Invalid task ID
     if (stk != NULL) {
-      rt_free_mem(os_stack_mem, stk);           // Free allocated stack
+      sysStackFree(stk);                        // Free allocated stack
     }
     sysThreadError(osErrorNoMemory);            // Create task failed (Out of memory)
     return NULL;
@@ -699,6 +930,30 @@ osThreadId svcThreadCreate (const osThreadDef_t *thread_def, void *argument) {
   return ptcb;
 }
 
+#ifdef CONFIG_RTX_PREEMPT_THR
+/// Create a thread with a preemption threshold
+osThreadId svcThreadCreateEx (const osThreadDef_t *thread_def, void *argument, osPriority threshold) {
+  P_TCB ptcb;
+
+  if ((thread_def == NULL) ||
+      (threshold < thread_def->tpriority) ||
+      (threshold > osPriorityRealtime)) {
+    sysThreadError(osErrorParameter);
+    return NULL;
+  }
+
+  ptcb = svcThreadCreate(thread_def, argument);
+  if (ptcb == NULL) {
+    return NULL;
+  }
+
+  // The thread may already run when it preempted the caller
+  rt_tsk_thr(ptcb, (uint8_t)(threshold - osPriorityIdle + 1));
+
+  return ptcb;
+}
+#endif
+
 /// Return the thread ID of the current running thread
 osThreadId svcThreadGetId (void) {
   OS_TID tsk;
@@ -728,7 +983,7 @@ osStatus svcThreadTerminate (osThreadId thread_id) {
   }
 
   if (stk != NULL) {                            
-    rt_free_mem(os_stack_mem, stk);             // Free private stack
+    sysStackFree(stk);                          // Free private stack
   }
 
   return osOK;
@@ -778,6 +1033,44 @@ osPriority svcThreadGetPriority (osThreadId thread_id) {
   return (osPriority)(ptcb->prio - 1 + osPriorityIdle); 
 }
 
+#ifdef CONFIG_RTX_ROBIN_SLICE
+/// Set the round robin time slice of an active thread
+osStatus svcThreadSetSlice (osThreadId thread_id, uint32_t millisec) {
+  P_TCB    ptcb;
+  uint32_t tick;
+
+  ptcb = rt_tid2ptcb(thread_id);                // Get TCB pointer
+  if (ptcb == NULL) {
+    return osErrorParameter;
+  }
+  if (millisec == osWaitForever) {
+    return osErrorValue;
+  }
+
+  tick = rt_ms2tick(millisec);
+  if (tick > 0xFFFEU) {
+    tick = 0xFFFEU;                             // Longest slice
+  }
+  rt_robin_slice(ptcb, (uint16_t)tick);         // 0: default slice
+
+  return osOK;
+}
+
+/// Turn round robin on or off for the threads of one priority
+osStatus svcRoundRobinSet (osPriority priority, uint32_t enable) {
+  if ((priority < osPriorityIdle) || (priority > osPriorityRealtime)) {
+    return osErrorValue;
+  }
+
+  rt_robin_prio(                                // Set round robin of level
+    (uint8_t)(priority - osPriorityIdle + 1),   // Task priority
+    (enable != 0U) ? __TRUE : __FALSE
+  );
+
+  return osOK;
+}
+#endif
+
 
 // Thread Public API
 
@@ -794,6 +1087,22 @@ osThreadId osThreadCreate (const osThreadDef_t *thread_def, void *argument) {
   }
 }
 
+#ifdef CONFIG_RTX_PREEMPT_THR
+/// Create a thread with a preemption threshold
+osThreadId osThreadCreateEx (const osThreadDef_t *thread_def, void *argument,
+                             osPriority threshold) {
+  if (__get_IPSR() != 0U) {
+    return NULL;                                // Not allowed in ISR
+  }
+  if (((__get_CONTROL() & 1U) == 0U) && (os_running == 0U)) {
+    // Privileged and not running
+    return   svcThreadCreateEx(thread_def, argument, threshold);
+  } else {
+    return __svcThreadCreateEx(thread_def, argument, threshold);
+  }
+}
+#endif
+
 /// Return the thread ID of the current running thread
 osThreadId osThreadGetId (void) {
   if (__get_IPSR() != 0U) {
@@ -834,6 +1143,24 @@ osPriority osThreadGetPriority (osThreadId thread_id) {
   return __svcThreadGetPriority(thread_id);
 }
 
+#ifdef CONFIG_RTX_ROBIN_SLICE
+/// Set the round robin time slice of an active thread
+osStatus osThreadSetSlice (osThreadId thread_id, uint32_t millisec) {
+  if (__get_IPSR() != 0U) {
+    return osErrorISR;                          // Not allowed in ISR
+  }
+  return __svcThreadSetSlice(thread_id, millisec);
+}
+
+/// Turn round robin on or off for the threads of one priority
+osStatus osRoundRobinSet (osPriority priority, uint32_t enable) {
+  if (__get_IPSR() != 0U) {
+    return osErrorISR;                          // Not allowed in ISR
+  }
+  return __svcRoundRobinSet(priority, enable);
+}
+#endif
+
 /// INTERNAL - Not Public
 /// Auto Terminate Thread on exit (used implicitly when thread exists)
 __NO_RETURN void osThreadExit (void) { 
@@ -904,98 +1231,382 @@ os_InRegs osEvent osWait (uint32_t millisec) {
 #endif
 }
 
+#ifdef CONFIG_RTX_WAIT_ANY
 
-// ==== Timer Management ====
-
-// Timer definitions
-#define osTimerInvalid  0U
-#define osTimerStopped  1U
-#define osTimerRunning  2U
-
-// Timer structures 
-
-typedef struct os_timer_cb_ {                   // Timer Control Block
-  struct os_timer_cb_ *next;                    // Pointer to next active Timer
-  uint8_t             state;                    // Timer State
-  uint8_t              type;                    // Timer Type (Periodic/One-shot)
-  uint16_t         reserved;                    // Reserved
-  uint32_t             tcnt;                    // Timer Delay Count
-  uint32_t             icnt;                    // Timer Initial Count 
-  void                 *arg;                    // Timer Function Argument
-  const osTimerDef_t *timer;                    // Pointer to Timer definition
-} os_timer_cb;
+// Multi-object Wait Service Calls declarations
+SVC_2_1(svcWaitAny,         int32_t,  struct OS_WAIT *, uint32_t, RET_int32_t)
 
-// Timer variables
-os_timer_cb *os_timer_head;                     // Pointer to first active Timer
+// Multi-object Wait Service Calls
 
+/// Wait for any of several Semaphores, Message Queues or Signals
+int32_t svcWaitAny (struct OS_WAIT *wait, uint32_t millisec) {
+  return rt_wait_any(wait, rt_ms2tick(millisec));
+}
 
-// Timer Helper Functions
+// Multi-object Wait Public API
 
-// Insert Timer into the list sorted by time
-static void rt_timer_insert (os_timer_cb *pt, uint32_t tcnt) {
-  os_timer_cb *p, *prev;
+/// Wait for any of several Semaphores, Message Queues, Mail Queues or Signals
+int32_t osWaitAny (void * const *objects, uint32_t count, int32_t signals, uint32_t *value, uint32_t millisec) {
+  struct OS_WAIT wait;
+  P_XCB          obj;
+  uint32_t       i;
 
-  prev = NULL;
-  p = os_timer_head;
-  while (p != NULL) {
-    if (tcnt < p->tcnt) { break; }
-    tcnt -= p->tcnt;
-    prev = p;
-    p = p->next;
-  }
-  pt->next = p;
-  pt->tcnt = tcnt;
-  if (p != NULL) {
-    p->tcnt -= pt->tcnt;
+  if (__get_IPSR() != 0U) {
+    return -2;                                  // Not allowed in ISR
   }
-  if (prev != NULL) {
-    prev->next = pt;
-  } else {
-    os_timer_head = pt;
+  if ((count > OS_WAIT_MAX) || ((count != 0U) && (objects == NULL))) {
+    return -2;
   }
-}
-
-// Remove Timer from the list
-static int32_t rt_timer_remove (os_timer_cb *pt) {
-  os_timer_cb *p, *prev;
-
-  prev = NULL;
-  p = os_timer_head;
-  while (p != NULL) {
-    if (p == pt) { break; }
-    prev = p;
-    p = p->next;
+  if ((uint32_t)signals & (0xFFFFFFFFU << osFeature_Signals)) {
+    return -2;
   }
-  if (p == NULL) { return -1; }
-  if (prev != NULL) {
-    prev->next = pt->next;
-  } else {
-    os_timer_head = pt->next;
+  if ((count == 0U) && (signals == 0)) {
+    return -2;                                  // Nothing to wait for
   }
-  if (pt->next != NULL) {
-    pt->next->tcnt += pt->tcnt;
+  for (i = 0U; i < count; i++) {
+    obj = rt_id2obj(objects[i]);
+    if ((obj == NULL) || ((obj->cb_type != SCB) && (obj->cb_type != MCB))) {
+      return -2;
+    }
+    wait.node[i].obj = obj;
   }
+  wait.cnt     = (U16)count;
+  wait.signals = (U16)signals;
 
-  return 0;
+  // A thread that blocks finds the result in 'wait', the return value of
+  // the service call is overwritten by the object that wakes it up
+  __svcWaitAny(&wait, millisec);
+
+  if ((wait.idx >= 0) && (value != NULL)) {
+    *value = wait.val;
+  }
+  return wait.idx;
 }
 
+#endif
 
-// Timer Service Calls declarations
-SVC_3_1(svcTimerCreate,           osTimerId,  const osTimerDef_t *, os_timer_type, void *, RET_pointer)
-SVC_2_1(svcTimerStart,            osStatus,         osTimerId,      uint32_t,              RET_osStatus)
-SVC_1_1(svcTimerStop,             osStatus,         osTimerId,                             RET_osStatus)
-SVC_1_1(svcTimerDelete,           osStatus,         osTimerId,                             RET_osStatus)
-SVC_1_2(svcTimerCall,   os_InRegs osCallback,       osTimerId,                             RET_osCallback)
 
-// Timer Management Service Calls
+#ifdef CONFIG_RTX_EDF
 
-/// Create timer
-osTimerId svcTimerCreate (const osTimerDef_t *timer_def, os_timer_type type, void *argument) {
-  os_timer_cb *pt;
+// ==== Earliest Deadline First Scheduling ====
 
-  if ((timer_def == NULL) || (timer_def->ptimer == NULL)) {
-    sysThreadError(osErrorParameter);
-    return NULL;
+// EDF Service Calls declarations
+SVC_2_1(svcEdfStart,  osStatus, uint32_t,   uint32_t, RET_osStatus)
+SVC_0_1(svcEdfWait,   osStatus,                       RET_osStatus)
+SVC_1_1(svcEdfMisses, uint32_t, osThreadId,           RET_uint32_t)
+
+// EDF Service Calls
+
+/// Schedule the running thread by deadline with a period and a relative deadline
+osStatus svcEdfStart (uint32_t period, uint32_t deadline) {
+  uint32_t prd, dl;
+
+  if ((period == osWaitForever) || (deadline > period)) {
+    return osErrorValue;
+  }
+  prd = rt_ms2tick(period);
+  dl  = (deadline != 0U) ? rt_ms2tick(deadline) : prd;
+
+  rt_edf_set(prd, dl);                          // First job released now
+
+  return osOK;
+}
+
+/// End the job of the running thread and wait for the release of the next
+osStatus svcEdfWait (void) {
+  if (os_tsk.run->edf_period == 0U) {
+    return osErrorResource;                     // Not scheduled by deadline
+  }
+
+  rt_edf_wait();
+
+  return osOK;
+}
+
+/// Get the number of jobs of a thread that ended after their deadline
+uint32_t svcEdfMisses (osThreadId thread_id) {
+  P_TCB ptcb;
+
+  ptcb = rt_tid2ptcb(thread_id);                // Get TCB pointer
+  if (ptcb == NULL) {
+    return 0U;
+  }
+
+  return ptcb->edf_miss;
+}
+
+
+// EDF Public API
+
+/// Schedule the running thread by deadline with a period and a relative deadline
+osStatus osEdfStart (uint32_t period, uint32_t deadline) {
+  if (__get_IPSR() != 0U) {
+    return osErrorISR;                          // Not allowed in ISR
+  }
+  return __svcEdfStart(period, deadline);
+}
+
+/// End the job of the running thread and wait for the release of the next
+osStatus osEdfWait (void) {
+  if (__get_IPSR() != 0U) {
+    return osErrorISR;                          // Not allowed in ISR
+  }
+  return __svcEdfWait();
+}
+
+/// Get the number of jobs of a thread that ended after their deadline
+uint32_t osEdfMisses (osThreadId thread_id) {
+  if (__get_IPSR() != 0U) {
+    return 0U;                                  // Not allowed in ISR
+  }
+  return __svcEdfMisses(thread_id);
+}
+
+#endif
+
+
+#ifdef CONFIG_RTX_PERIODIC
+
+// ==== Periodic Threads ====
+
+// Periodic Thread Service Calls declarations
+SVC_1_1(svcPeriodDelay, osStatus, uint32_t, RET_osStatus)
+
+// Periodic Thread Service Calls
+
+/// Wait for the kernel tick of a release
+osStatus svcPeriodDelay (uint32_t release) {
+  uint32_t delay;
+
+  delay = release - os_time;                    // No tick until the task blocks
+  if ((int32_t)delay > 0) {
+    rt_dly_wait(delay);
+  }
+
+  return osOK;
+}
+
+
+// Periodic Thread Public API
+
+/// Start a periodic loop in the running thread
+osStatus osPeriodStart (osPeriod *period, uint32_t millisec) {
+  uint64_t ticks;
+
+  if (__get_IPSR() != 0U) {
+    return osErrorISR;                          // Not allowed in ISR
+  }
+  if (period == NULL) {
+    return osErrorParameter;
+  }
+  ticks = ((1000U * (uint64_t)millisec) + os_clockrate - 1U) / os_clockrate;
+  if ((ticks == 0U) || (ticks > 0x7FFFFFFFU)) {
+    return osErrorValue;                        // Releases compared as signed
+  }
+
+  period->period     = (uint32_t)ticks;
+  period->release    = os_time;                 // First job released now
+  period->start      = osKernelSysTick();
+  period->jobs       = 0U;
+  period->overruns   = 0U;
+  period->jitter_max = 0U;
+  period->jitter_sum = 0U;
+  period->exec_max   = 0U;
+  period->exec_sum   = 0U;
+
+  return osOK;
+}
+
+/// End the job of the running thread and wait for the release of the next
+osStatus osPeriodWait (osPeriod *period) {
+  uint32_t now, time, skip;
+
+  if (__get_IPSR() != 0U) {
+    return osErrorISR;                          // Not allowed in ISR
+  }
+  if ((period == NULL) || (period->period == 0U)) {
+    return osErrorParameter;
+  }
+
+  // Job time, preemptions included
+  now  = osKernelSysTick();
+  time = now - period->start;
+  period->jobs++;
+  period->exec_sum += time;
+  if (time > period->exec_max) {
+    period->exec_max = time;
+  }
+
+  // Next release on the grid of the first one, skip those already passed
+  period->release += period->period;
+  skip = os_time - period->release;
+  if ((int32_t)skip >= 0) {
+    skip = (skip / period->period) + 1U;
+    period->overruns += skip;
+    period->release  += skip * period->period;
+  }
+  __svcPeriodDelay(period->release);
+
+  // Release jitter, the release tick in system timer counts
+  now  = osKernelSysTick();
+  time = now - (period->release * (os_trv + 1U));
+  period->start = now;
+  period->jitter_sum += time;
+  if (time > period->jitter_max) {
+    period->jitter_max = time;
+  }
+
+  return osOK;
+}
+
+#endif
+
+
+// ==== Timer Management ====
+
+// Timer definitions
+#define osTimerInvalid  0U
+#define osTimerStopped  1U
+#define osTimerRunning  2U
+
+// Timer structures 
+
+typedef struct os_timer_cb_ {                   // Timer Control Block
+  struct os_timer_cb_ *next;                    // Pointer to next active Timer
+#ifdef CONFIG_RTX_TMR_WHEEL
+  struct os_timer_cb_ *prev;                    // Pointer to previous Timer in wheel slot
+#endif
+  uint8_t             state;                    // Timer State
+  uint8_t              type;                    // Timer Type (Periodic/One-shot)
+  uint16_t         reserved;                    // Reserved
+  uint32_t             tcnt;                    // Timer Delay Count (wheel: Expiry Time)
+  uint32_t             icnt;                    // Timer Initial Count 
+  void                 *arg;                    // Timer Function Argument
+  const osTimerDef_t *timer;                    // Pointer to Timer definition
+} os_timer_cb;
+
+// Timer variables
+#ifdef CONFIG_RTX_TMR_WHEEL
+#define os_timer_slots  (1U << CONFIG_RTX_TMR_WHEEL_BITS)
+#define os_timer_slot_of(time) ((uint32_t)(time) & (os_timer_slots - 1U))
+
+os_timer_cb *os_timer_wheel[os_timer_slots];    // Active Timers hashed by Expiry Time
+uint32_t     os_timer_time;                     // Timer Wheel current time
+uint32_t     os_timer_cnt;                      // Number of active Timers
+#else
+os_timer_cb *os_timer_head;                     // Pointer to first active Timer
+#endif
+
+
+// Timer Helper Functions
+
+#ifdef CONFIG_RTX_TMR_WHEEL
+
+// Link Timer into the wheel slot of its Expiry Time
+static void rt_timer_link (os_timer_cb *pt) {
+  os_timer_cb **slot;
+
+  slot = &os_timer_wheel[os_timer_slot_of(pt->tcnt)];
+  pt->prev = NULL;
+  pt->next = *slot;
+  if (pt->next != NULL) {
+    pt->next->prev = pt;
+  }
+  *slot = pt;
+  os_timer_cnt++;
+}
+
+// Insert Timer to expire "tcnt" ticks from now
+static void rt_timer_insert (os_timer_cb *pt, uint32_t tcnt) {
+  pt->tcnt = os_timer_time + tcnt;
+  rt_timer_link(pt);
+}
+
+// Remove Timer from its wheel slot
+static int32_t rt_timer_remove (os_timer_cb *pt) {
+
+  if (pt->prev != NULL) {
+    pt->prev->next = pt->next;
+  } else {
+    os_timer_wheel[os_timer_slot_of(pt->tcnt)] = pt->next;
+  }
+  if (pt->next != NULL) {
+    pt->next->prev = pt->prev;
+  }
+  os_timer_cnt--;
+
+  return 0;
+}
+
+#else
+
+// Insert Timer into the list sorted by time
+static void rt_timer_insert (os_timer_cb *pt, uint32_t tcnt) {
+  os_timer_cb *p, *prev;
+
+  prev = NULL;
+  p = os_timer_head;
+  while (p != NULL) {
+    if (tcnt < p->tcnt) { break; }
+    tcnt -= p->tcnt;
+    prev = p;
+    p = p->next;
+  }
+  pt->next = p;
+  pt->tcnt = tcnt;
+  if (p != NULL) {
+    p->tcnt -= pt->tcnt;
+  }
+  if (prev != NULL) {
+    prev->next = pt;
+  } else {
+    os_timer_head = pt;
+  }
+}
+
+// Remove Timer from the list
+static int32_t rt_timer_remove (os_timer_cb *pt) {
+  os_timer_cb *p, *prev;
+
+  prev = NULL;
+  p = os_timer_head;
+  while (p != NULL) {
+    if (p == pt) { break; }
+    prev = p;
+    p = p->next;
+  }
+  if (p == NULL) { return -1; }
+  if (prev != NULL) {
+    prev->next = pt->next;
+  } else {
+    os_timer_head = pt->next;
+  }
+  if (pt->next != NULL) {
+    pt->next->tcnt += pt->tcnt;
+  }
+
+  return 0;
+}
+
+#endif
+
+
+// Timer Service Calls declarations
+SVC_3_1(svcTimerCreate,           osTimerId,  const osTimerDef_t *, os_timer_type, void *, RET_pointer)
+SVC_2_1(svcTimerStart,            osStatus,         osTimerId,      uint32_t,              RET_osStatus)
+SVC_1_1(svcTimerStop,             osStatus,         osTimerId,                             RET_osStatus)
+SVC_1_1(svcTimerDelete,           osStatus,         osTimerId,                             RET_osStatus)
+SVC_1_2(svcTimerCall,   os_InRegs osCallback,       osTimerId,                             RET_osCallback)
+
+// Timer Management Service Calls
+
+/// Create timer
+osTimerId svcTimerCreate (const osTimerDef_t *timer_def, os_timer_type type, void *argument) {
+  os_timer_cb *pt;
+
+  if ((timer_def == NULL) || (timer_def->ptimer == NULL)) {
+    sysThreadError(osErrorParameter);
+    return NULL;
   }
 
   pt = timer_def->timer;
@@ -1130,6 +1741,41 @@ void sysTimerTick (void) {
   os_timer_cb *pt, *p;
   osStatus     status;
 
+#ifdef CONFIG_RTX_TMR_WHEEL
+  os_timer_cb *fired;
+
+  os_timer_time++;
+  if (os_timer_cnt == 0U) { return; }
+
+  // Detach all Timers due at this tick in one pass over the slot
+  fired = NULL;
+  p = os_timer_wheel[os_timer_slot_of(os_timer_time)];
+  while (p != NULL) {
+    pt = p;
+    p  = p->next;
+    if (pt->tcnt == os_timer_time) {
+      rt_timer_remove(pt);
+      pt->next = fired;
+      fired    = pt;
+    }
+  }
+
+  while (fired != NULL) {
+    pt    = fired;
+    fired = pt->next;
+    status = isrMessagePut(osMessageQId_osTimerMessageQ, (uint32_t)pt, 0U);
+    if (status != osOK) {
+      os_error(OS_ERR_TIMER_OVF);
+    }
+    if (pt->type == (uint8_t)osTimerPeriodic) {
+      // Re-arm from the deadline just reached, not from now
+      pt->tcnt += pt->icnt;
+      rt_timer_link(pt);
+    } else {
+      pt->state = osTimerStopped;
+    }
+  }
+#else
   p = os_timer_head;
   if (p == NULL) { return; }
 
@@ -1148,20 +1794,53 @@ void sysTimerTick (void) {
       pt->state = osTimerStopped;
     }
   }
+#endif
 }
 
 /// Get user timers wake-up time 
 uint32_t sysUserTimerWakeupTime (void) {
+#ifdef CONFIG_RTX_TMR_WHEEL
+  os_timer_cb *pt;
+  uint32_t     i, delta, next;
+
+  next = 0xFFFFFFFFU;
+  if (os_timer_cnt == 0U) { return next; }
 
+  // A Timer due within one wheel turn sits in the slot of its delay,
+  // stop at the first slot holding such a Timer
+  for (i = 1U; i <= os_timer_slots; i++) {
+    for (pt = os_timer_wheel[os_timer_slot_of(os_timer_time + i)]; pt != NULL; pt = pt->next) {
+      delta = pt->tcnt - os_timer_time;
+      if (delta < next) { next = delta; }
+    }
+    if (next <= i) { break; }
+  }
+  return next;
+#else
   if (os_timer_head) {
     return os_timer_head->tcnt;
   }
   return 0xFFFFFFFFU;
+#endif
 }
 
 /// Update user timers on resume
 void sysUserTimerUpdate (uint32_t sleep_time) {
-
+#ifdef CONFIG_RTX_TMR_WHEEL
+  uint32_t next;
+
+  // Skip ahead to each expiry instead of ticking through the sleep
+  while (sleep_time != 0U) {
+    next = sysUserTimerWakeupTime();
+    if (next > sleep_time) {
+      os_timer_time += sleep_time;
+      break;
+    }
+    os_timer_time += next - 1U;
+    sleep_time    -= next;
+    sysTimerTick();
+  }
+#else
   while ((os_timer_head != NULL) && (sleep_time != 0U)) {
     if (sleep_time >= os_timer_head->tcnt) {
       sleep_time -= os_timer_head->tcnt;
@@ -1172,6 +1851,7 @@ void sysUserTimerUpdate (uint32_t sleep_time) {
       break;
     }
   }
+#endif
 }
 
 
@@ -1475,6 +2155,103 @@ osStatus svcMutexDelete (osMutexId mutex_id) {
 }
 
 
+#ifdef CONFIG_RTX_FAST_SYNC
+
+// Mutex Fast Path
+
+// Take a free mutex or nest one the running thread owns, in thread mode
+static BOOL sysMutexFastWait (osMutexId mutex_id) {
+  P_MUCB p_MCB;
+  P_TCB  p_TCB;
+
+  p_MCB = rt_id2obj(mutex_id);
+  if ((p_MCB == NULL) || (p_MCB->cb_type != MUCB) || (os_running == 0U)) {
+    return __FALSE;
+  }
+  p_TCB = os_tsk.run;
+
+  if (p_MCB->owner == p_TCB) {
+    if (p_MCB->level == 0xFFFFU) {
+      return __FALSE;
+    }
+    p_MCB->level++;
+    return __TRUE;
+  }
+
+  // The owner is the lock word: claim it, then take the rest of the mutex.
+  // Until it is on the owner list, p_mfast lets rt_tsk_delete find it.
+  p_TCB->p_mfast = p_MCB;
+  do {
+    if (rt_ldrex_p(&p_MCB->owner) != NULL) {
+      rt_clrex();
+      p_TCB->p_mfast = NULL;
+      return __FALSE;
+    }
+  } while (rt_strex_p(p_TCB, &p_MCB->owner));
+  p_MCB->level  = 1U;
+  p_MCB->p_mlnk = p_TCB->p_mlnk;
+  p_TCB->p_mlnk = p_MCB;
+  p_TCB->p_mfast = NULL;
+  return __TRUE;
+}
+
+// Give back a mutex nobody waits for, in thread mode. The owner must run at
+// its base priority, else the kernel has to restore it.
+static BOOL sysMutexFastRelease (osMutexId mutex_id) {
+  P_MUCB p_MCB, p_mlnk;
+  P_TCB  p_TCB;
+
+  p_MCB = rt_id2obj(mutex_id);
+  if ((p_MCB == NULL) || (p_MCB->cb_type != MUCB) || (os_running == 0U)) {
+    return __FALSE;
+  }
+  p_TCB = os_tsk.run;
+  if ((p_MCB->owner != p_TCB) || (p_MCB->level == 0U)) {
+    return __FALSE;
+  }
+  if (p_MCB->level > 1U) {
+    p_MCB->level--;
+    return __TRUE;
+  }
+  if ((p_MCB->p_lnk != NULL) || (p_TCB->prio != p_TCB->prio_base)) {
+    return __FALSE;
+  }
+
+  // Remove the mutex from the owner list while still owning it, p_mfast
+  // lets rt_tsk_delete find it until the owner is cleared
+  p_TCB->p_mfast = p_MCB;
+  p_mlnk = p_TCB->p_mlnk;
+  if (p_mlnk == p_MCB) {
+    p_TCB->p_mlnk = p_MCB->p_mlnk;
+  } else {
+    while (p_mlnk != NULL) {
+      if (p_mlnk->p_mlnk == p_MCB) {
+        p_mlnk->p_mlnk = p_MCB->p_mlnk;
+        break;
+      }
+      p_mlnk = p_mlnk->p_mlnk;
+    }
+  }
+  p_MCB->level = 0U;
+
+  do {
+    (void)rt_ldrex_p(&p_MCB->owner);
+    if ((p_MCB->p_lnk != NULL) || (p_TCB->prio != p_TCB->prio_base)) {
+      // A thread started to wait meanwhile: link back, let the kernel hand over
+      rt_clrex();
+      p_MCB->level  = 1U;
+      p_MCB->p_mlnk = p_TCB->p_mlnk;
+      p_TCB->p_mlnk = p_MCB;
+      p_TCB->p_mfast = NULL;
+      return __FALSE;
+    }
+  } while (rt_strex_p(NULL, &p_MCB->owner));
+  p_TCB->p_mfast = NULL;
+  return __TRUE;
+}
+
+#endif
+
 // Mutex Public API
 
 /// Create and Initialize a Mutex object
@@ -1495,6 +2272,11 @@ osStatus osMutexWait (osMutexId mutex_id, uint32_t millisec) {
   if (__get_IPSR() != 0U) {
     return osErrorISR;                          // Not allowed in ISR
   }
+#ifdef CONFIG_RTX_FAST_SYNC
+  if (sysMutexFastWait(mutex_id)) {
+    return osOK;
+  }
+#endif
   return __svcMutexWait(mutex_id, millisec);
 }
 
@@ -1503,6 +2285,11 @@ osStatus osMutexRelease (osMutexId mutex_id) {
   if (__get_IPSR() != 0U) {
     return osErrorISR;                          // Not allowed in ISR
   }
+#ifdef CONFIG_RTX_FAST_SYNC
+  if (sysMutexFastRelease(mutex_id)) {
+    return osOK;
+  }
+#endif
   return __svcMutexRelease(mutex_id);
 }
 
@@ -1589,10 +2376,17 @@ osStatus svcSemaphoreRelease (osSemaphoreId semaphore_id) {
     return osErrorParameter;
   }
 
-  if ((int32_t)((P_SCB)sem)->tokens == osFeature_Semaphore) {
+#ifdef CONFIG_RTX_PSQ_COALESCE
+  // Tokens released by ISRs and not posted yet count as well
+  if (((int32_t)((P_SCB)sem)->tokens + (int32_t)((P_SCB)sem)->isr_tokens) >= osFeature_Semaphore) {
     return osErrorResource;
   }
-  
+#else
+  if ((int32_t)((P_SCB)sem)->tokens == osFeature_Semaphore) {
+    return osErrorResource;
+  }
+#endif
+  
   rt_sem_send(sem);                             // Release Semaphore
 
   return osOK;
@@ -1632,9 +2426,16 @@ osStatus isrSemaphoreRelease (osSemaphoreId semaphore_id) {
     return osErrorParameter;
   }
 
+#ifdef CONFIG_RTX_PSQ_COALESCE
+  // Tokens released by ISRs and not posted yet count as well
+  if (((int32_t)((P_SCB)sem)->tokens + (int32_t)((P_SCB)sem)->isr_tokens) >= osFeature_Semaphore) {
+    return osErrorResource;
+  }
+#else
   if ((int32_t)((P_SCB)sem)->tokens == osFeature_Semaphore) {
     return osErrorResource;
   }
+#endif
 
   isr_sem_send(sem);                            // Release Semaphore
 
@@ -1642,6 +2443,55 @@ osStatus isrSemaphoreRelease (osSemaphoreId semaphore_id) {
 }
 
 
+#ifdef CONFIG_RTX_FAST_SYNC
+
+// Semaphore Fast Path
+
+// Take a token in thread mode, return the tokens there were or 0 if none
+static int32_t sysSemaphoreFastWait (osSemaphoreId semaphore_id) {
+  P_SCB    p_SCB;
+  uint32_t tokens;
+
+  p_SCB = rt_id2obj(semaphore_id);
+  if ((p_SCB == NULL) || (p_SCB->cb_type != SCB) || (os_running == 0U)) {
+    return 0;
+  }
+  do {
+    tokens = rt_ldrex_h(&p_SCB->tokens);
+    if (tokens == 0U) {
+      rt_clrex();
+      return 0;
+    }
+  } while (rt_strex_h(tokens - 1U, &p_SCB->tokens));
+  return (int32_t)tokens;
+}
+
+// Give back a token nobody waits for, in thread mode
+static BOOL sysSemaphoreFastRelease (osSemaphoreId semaphore_id) {
+  P_SCB    p_SCB;
+  uint32_t tokens;
+
+  p_SCB = rt_id2obj(semaphore_id);
+  if ((p_SCB == NULL) || (p_SCB->cb_type != SCB) || (os_running == 0U)) {
+    return __FALSE;
+  }
+  do {
+    tokens = rt_ldrex_h(&p_SCB->tokens);
+#ifdef CONFIG_RTX_PSQ_COALESCE
+    // Tokens released by ISRs and not posted yet count as well
+    if ((p_SCB->p_lnk != NULL) || ((int32_t)(tokens + p_SCB->isr_tokens) >= osFeature_Semaphore)) {
+#else
+    if ((p_SCB->p_lnk != NULL) || ((int32_t)tokens == osFeature_Semaphore)) {
+#endif
+      rt_clrex();
+      return __FALSE;
+    }
+  } while (rt_strex_h(tokens + 1U, &p_SCB->tokens));
+  return __TRUE;
+}
+
+#endif
+
 // Semaphore Public API
 
 /// Create and Initialize a Semaphore object
@@ -1662,6 +2512,14 @@ int32_t osSemaphoreWait (osSemaphoreId semaphore_id, uint32_t millisec) {
   if (__get_IPSR() != 0U) {
     return -1;                                  // Not allowed in ISR
   }
+#ifdef CONFIG_RTX_FAST_SYNC
+  {
+    int32_t tokens = sysSemaphoreFastWait(semaphore_id);
+    if (tokens != 0) {
+      return tokens;
+    }
+  }
+#endif
   return __svcSemaphoreWait(semaphore_id, millisec);
 }
 
@@ -1670,6 +2528,11 @@ osStatus osSemaphoreRelease (osSemaphoreId semaphore_id) {
   if (__get_IPSR() != 0U) {                     // in ISR
     return   isrSemaphoreRelease(semaphore_id);
   } else {                                      // in Thread
+#ifdef CONFIG_RTX_FAST_SYNC
+    if (sysSemaphoreFastRelease(semaphore_id)) {
+      return osOK;
+    }
+#endif
     return __svcSemaphoreRelease(semaphore_id);
   }
 }
@@ -1683,6 +2546,181 @@ osStatus osSemaphoreDelete (osSemaphoreId semaphore_id) {
 }
 
 
+#ifdef CONFIG_RTX_EVT_GROUP
+
+// ==== Event Group Management ====
+
+// Event Group Service Calls declarations
+SVC_1_1(svcEventGroupCreate, osEventGroupId, const osEventGroupDef_t *,                         RET_pointer)
+SVC_2_1(svcEventGroupSet,    osStatus,       osEventGroupId, uint32_t,                          RET_osStatus)
+SVC_2_1(svcEventGroupClear,  uint32_t,       osEventGroupId, uint32_t,                          RET_uint32_t)
+SVC_4_1(svcEventGroupWait,   uint32_t,       osEventGroupId, uint32_t, uint32_t, uint32_t,      RET_uint32_t)
+SVC_1_1(svcEventGroupDelete, osStatus,       osEventGroupId,                                    RET_osStatus)
+
+// Event Group Service Calls
+
+/// Check an Event Group ID
+static P_EGRP sysEventGroup (osEventGroupId egroup_id) {
+  P_EGRP p_EG;
+
+  p_EG = rt_id2obj(egroup_id);
+  if ((p_EG == NULL) || (p_EG->cb_type != EGCB)) {
+    return NULL;
+  }
+  return p_EG;
+}
+
+/// Create and Initialize an Event Group object
+osEventGroupId svcEventGroupCreate (const osEventGroupDef_t *egroup_def) {
+  OS_ID egrp;
+
+  if (egroup_def == NULL) {
+    sysThreadError(osErrorParameter);
+    return NULL;
+  }
+
+  egrp = egroup_def->egroup;
+  if (egrp == NULL) {
+    sysThreadError(osErrorParameter);
+    return NULL;
+  }
+
+  if (((P_EGRP)egrp)->cb_type != 0U) {
+    sysThreadError(osErrorParameter);
+    return NULL;
+  }
+
+  rt_egrp_init(egrp);                           // Initialize Event Group
+
+  return egrp;
+}
+
+/// Set flags of an Event Group
+osStatus svcEventGroupSet (osEventGroupId egroup_id, uint32_t flags) {
+  P_EGRP p_EG = sysEventGroup(egroup_id);
+
+  if (p_EG == NULL) {
+    return osErrorParameter;
+  }
+
+  rt_egrp_set(p_EG, flags);                     // Set flags, wake waiters
+
+  return osOK;
+}
+
+/// Clear flags of an Event Group
+uint32_t svcEventGroupClear (osEventGroupId egroup_id, uint32_t flags) {
+  P_EGRP p_EG = sysEventGroup(egroup_id);
+
+  if (p_EG == NULL) {
+    return 0U;
+  }
+
+  return rt_egrp_clr(p_EG, flags);
+}
+
+/// Wait for flags of an Event Group
+uint32_t svcEventGroupWait (osEventGroupId egroup_id, uint32_t flags, uint32_t options, uint32_t millisec) {
+  P_EGRP p_EG = sysEventGroup(egroup_id);
+
+  if ((p_EG == NULL) || (flags == 0U)) {
+    return 0U;
+  }
+
+  return rt_egrp_wait(p_EG, flags, options, rt_ms2tick(millisec));
+}
+
+/// Delete an Event Group
+osStatus svcEventGroupDelete (osEventGroupId egroup_id) {
+  P_EGRP p_EG = sysEventGroup(egroup_id);
+
+  if (p_EG == NULL) {
+    return osErrorParameter;
+  }
+
+  rt_egrp_delete(p_EG);                         // Delete Event Group
+
+  return osOK;
+}
+
+
+// Event Group ISR Calls
+
+/// Set flags of an Event Group
+osStatus isrEventGroupSet (osEventGroupId egroup_id, uint32_t flags) {
+  P_EGRP p_EG = sysEventGroup(egroup_id);
+
+  if (p_EG == NULL) {
+    return osErrorParameter;
+  }
+
+  isr_egrp_set(p_EG, flags);                    // Set flags
+
+  return osOK;
+}
+
+
+// Event Group Public API
+
+/// Create and Initialize an Event Group object
+osEventGroupId osEventGroupCreate (const osEventGroupDef_t *egroup_def) {
+  if (__get_IPSR() != 0U) {
+    return NULL;                                // Not allowed in ISR
+  }
+  if (((__get_CONTROL() & 1U) == 0U) && (os_running == 0U)) {
+    // Privileged and not running
+    return   svcEventGroupCreate(egroup_def);
+  } else {
+    return __svcEventGroupCreate(egroup_def);
+  }
+}
+
+/// Set flags of an Event Group
+osStatus osEventGroupSet (osEventGroupId egroup_id, uint32_t flags) {
+  if (__get_IPSR() != 0U) {                     // in ISR
+    return   isrEventGroupSet(egroup_id, flags);
+  } else {                                      // in Thread
+    return __svcEventGroupSet(egroup_id, flags);
+  }
+}
+
+/// Clear flags of an Event Group
+uint32_t osEventGroupClear (osEventGroupId egroup_id, uint32_t flags) {
+  if (__get_IPSR() != 0U) {
+    return 0U;                                  // Not allowed in ISR
+  }
+  return __svcEventGroupClear(egroup_id, flags);
+}
+
+/// Get the flags of an Event Group
+uint32_t osEventGroupGet (osEventGroupId egroup_id) {
+  P_EGRP p_EG = sysEventGroup(egroup_id);
+
+  if (p_EG == NULL) {
+    return 0U;
+  }
+  return p_EG->flags;
+}
+
+/// Wait for flags of an Event Group
+uint32_t osEventGroupWait (osEventGroupId egroup_id, uint32_t flags, uint32_t options, uint32_t millisec) {
+  if (__get_IPSR() != 0U) {
+    return 0U;                                  // Not allowed in ISR
+  }
+  return __svcEventGroupWait(egroup_id, flags, options, millisec);
+}
+
+/// Delete an Event Group
+osStatus osEventGroupDelete (osEventGroupId egroup_id) {
+  if (__get_IPSR() != 0U) {
+    return osErrorISR;                          // Not allowed in ISR
+  }
+  return __svcEventGroupDelete(egroup_id);
+}
+
+#endif
+
+
 // ==== Memory Management Functions ====
 
 // Memory Management Helper Functions
@@ -1810,6 +2848,8 @@ osStatus osPoolFree (osPoolId pool_id, void *block) {
 SVC_2_1(svcMessageCreate,        osMessageQId, const osMessageQDef_t *, osThreadId,           RET_pointer)
 SVC_3_1(svcMessagePut,           osStatus,           osMessageQId,      uint32_t,   uint32_t, RET_osStatus)
 SVC_2_3(svcMessageGet, os_InRegs osEvent,            osMessageQId,      uint32_t,             RET_osEvent)
+SVC_3_1(svcMessagePutN,          int32_t,            osMessageQId, const uint32_t *, uint32_t, RET_int32_t)
+SVC_3_1(svcMessageGetN,          int32_t,            osMessageQId,      uint32_t *, uint32_t, RET_int32_t)
 
 // Message Queue Service Calls
 
@@ -1881,6 +2921,34 @@ os_InRegs osEvent_type svcMessageGet (osMessageQId queue_id, uint32_t millisec)
   return osEvent_ret_value;
 }
 
+/// Put up to count Messages to a Queue without waiting
+int32_t svcMessagePutN (osMessageQId queue_id, const uint32_t *info, uint32_t count) {
+
+  if ((queue_id == NULL) || (info == NULL)) {
+    return -1;
+  }
+
+  if (((P_MCB)queue_id)->cb_type != MCB) {
+    return -1;
+  }
+
+  return (int32_t)rt_mbx_send_n(queue_id, info, count);
+}
+
+/// Get up to count Messages from a Queue without waiting
+int32_t svcMessageGetN (osMessageQId queue_id, uint32_t *info, uint32_t count) {
+
+  if ((queue_id == NULL) || (info == NULL)) {
+    return -1;
+  }
+
+  if (((P_MCB)queue_id)->cb_type != MCB) {
+    return -1;
+  }
+
+  return (int32_t)rt_mbx_wait_n(queue_id, info, count);
+}
+
 
 // Message Queue ISR Calls
 
@@ -1931,6 +2999,52 @@ os_InRegs osEvent isrMessageGet (osMessageQId queue_id, uint32_t millisec) {
   return ret;
 }
 
+/// Put up to count Messages to a Queue as one post
+int32_t isrMessagePutN (osMessageQId queue_id, const uint32_t *info, uint32_t count) {
+  uint32_t n;
+
+  if ((queue_id == NULL) || (info == NULL)) {
+    return -1;
+  }
+
+  if (((P_MCB)queue_id)->cb_type != MCB) {
+    return -1;
+  }
+
+  n = rt_mbx_check(queue_id);                   // Free space in the Queue
+  if (n > count) {
+    n = count;
+  }
+  if (n != 0U) {
+    isr_mbx_send_n(queue_id, (U32 *)info, n);
+  }
+
+  return (int32_t)n;
+}
+
+/// Get up to count Messages from a Queue
+int32_t isrMessageGetN (osMessageQId queue_id, uint32_t *info, uint32_t count) {
+  uint32_t n;
+  void    *msg;
+
+  if ((queue_id == NULL) || (info == NULL)) {
+    return -1;
+  }
+
+  if (((P_MCB)queue_id)->cb_type != MCB) {
+    return -1;
+  }
+
+  for (n = 0U; n < count; n++) {
+    if (isr_mbx_receive(queue_id, &msg) != OS_R_MBX) {
+      break;
+    }
+    info[n] = (uint32_t)msg;
+  }
+
+  return (int32_t)n;
+}
+
 
 // Message Queue Management Public API
 
@@ -1965,6 +3079,49 @@ os_InRegs osEvent osMessageGet (osMessageQId queue_id, uint32_t millisec) {
   }
 }
 
+/// Put up to count Messages to a Queue in one call
+int32_t osMessagePutN (osMessageQId queue_id, const uint32_t *info, uint32_t count, uint32_t millisec) {
+  int32_t n;
+
+  if (__get_IPSR() != 0U) {                     // in ISR
+    if (millisec != 0U) {
+      return -1;
+    }
+    return   isrMessagePutN(queue_id, info, count);
+  }
+  n = __svcMessagePutN(queue_id, info, count);  // in Thread
+  if ((n == 0) && (count != 0U) && (millisec != 0U)) {
+    // Queue full: wait for space for the first one
+    if (osMessagePut(queue_id, info[0], millisec) == osOK) {
+      n = 1;
+    }
+  }
+  return n;
+}
+
+/// Get up to count Messages from a Queue in one call
+int32_t osMessageGetN (osMessageQId queue_id, uint32_t *info, uint32_t count, uint32_t millisec) {
+  int32_t n;
+  osEvent evt;
+
+  if (__get_IPSR() != 0U) {                     // in ISR
+    if (millisec != 0U) {
+      return -1;
+    }
+    return   isrMessageGetN(queue_id, info, count);
+  }
+  n = __svcMessageGetN(queue_id, info, count);  // in Thread
+  if ((n == 0) && (count != 0U) && (millisec != 0U)) {
+    // Queue empty: wait for the first one
+    evt = osMessageGet(queue_id, millisec);
+    if (evt.status == osEventMessage) {
+      info[0] = evt.value.v;
+      n = 1;
+    }
+  }
+  return n;
+}
+
 
 // ==== Mail Queue Management Functions ====
 
@@ -2168,6 +3325,195 @@ os_InRegs osEvent osMailGet (osMailQId queue_id, uint32_t millisec) {
   return ret;
 }
 
+/// Put up to count mails to a queue in one call
+int32_t osMailPutN (osMailQId queue_id, void *const *mail, uint32_t count) {
+  if ((queue_id == NULL) || (mail == NULL)) {
+    return -1;
+  }
+  return osMessagePutN(*((void **)queue_id), (const uint32_t *)mail, count, 0U);
+}
+
+/// Get up to count mails from a queue in one call
+int32_t osMailGetN (osMailQId queue_id, void **mail, uint32_t count, uint32_t millisec) {
+  if ((queue_id == NULL) || (mail == NULL)) {
+    return -1;
+  }
+  return osMessageGetN(*((void **)queue_id), (uint32_t *)mail, count, millisec);
+}
+
+
+#ifdef CONFIG_RTX_MSGBUF
+
+//  ==== Message Buffer Management Functions ====
+
+// Message Buffer Management Service Calls declarations
+SVC_1_1(svcMsgBufCreate, osMsgBufId, const osMsgBufDef_t *,                       RET_pointer)
+SVC_4_1(svcMsgBufWait,   osStatus,   osMsgBufId, uint32_t, uint32_t, uint32_t, RET_osStatus)
+SVC_1_0(svcMsgBufWake,   void,       osMsgBufId)
+
+// Message Buffer Service Calls
+
+/// Create and Initialize a Message Buffer
+osMsgBufId svcMsgBufCreate (const osMsgBufDef_t *msgbuf_def) {
+
+  if ((msgbuf_def == NULL) ||
+      (msgbuf_def->msgbuf == NULL) ||
+      (msgbuf_def->size < 8U)) {
+    sysThreadError(osErrorParameter);
+    return NULL;
+  }
+
+  if (((P_MBF)msgbuf_def->msgbuf)->cb_type != 0U) {
+    sysThreadError(osErrorParameter);
+    return NULL;
+  }
+
+  rt_mbf_init(msgbuf_def->msgbuf, msgbuf_def->size);
+
+  return msgbuf_def->msgbuf;
+}
+
+/// Wait until a Message Buffer holds enough data
+osStatus svcMsgBufWait (osMsgBufId msgbuf_id, uint32_t bytes, uint32_t records, uint32_t millisec) {
+  OS_ID     mbf;
+  OS_RESULT res;
+
+  mbf = rt_id2obj(msgbuf_id);
+  if (mbf == NULL) {
+    return osErrorParameter;
+  }
+
+  if (((P_MBF)mbf)->cb_type != MBFCB) {
+    return osErrorParameter;
+  }
+
+  res = rt_mbf_wait(mbf, bytes, records, rt_ms2tick(millisec));
+
+  if (res == OS_R_TMO) {
+    return ((millisec != 0U) ? osErrorTimeoutResource : osErrorResource);
+  }
+  if (res == OS_R_NOK) {
+    return osErrorResource;                     // Another thread waits
+  }
+
+  return osOK;
+}
+
+/// Wake up the thread waiting on a Message Buffer
+void svcMsgBufWake (osMsgBufId msgbuf_id) {
+  rt_mbf_wake(msgbuf_id);
+}
+
+
+// Message Buffer Management Public API
+
+/// Check a Message Buffer ID, the data path does not enter the kernel
+static P_MBF sysMsgBuf (osMsgBufId msgbuf_id) {
+  P_MBF p_MBF;
+
+  p_MBF = rt_id2obj(msgbuf_id);
+  if ((p_MBF == NULL) || (p_MBF->cb_type != MBFCB)) {
+    return NULL;
+  }
+  return p_MBF;
+}
+
+/// Create and Initialize a Message Buffer
+osMsgBufId osMsgBufCreate (const osMsgBufDef_t *msgbuf_def) {
+  if (__get_IPSR() != 0U) {
+    return NULL;                                // Not allowed in ISR
+  }
+  if (((__get_CONTROL() & 1U) == 0U) && (os_running == 0U)) {
+    // Privileged and not running
+    return   svcMsgBufCreate(msgbuf_def);
+  } else {
+    return __svcMsgBufCreate(msgbuf_def);
+  }
+}
+
+/// Reserve room for a record in a Message Buffer
+void *osMsgBufReserve (osMsgBufId msgbuf_id, uint32_t size) {
+  P_MBF p_MBF = sysMsgBuf(msgbuf_id);
+
+  if (p_MBF == NULL) {
+    return NULL;
+  }
+  return rt_mbf_reserve(p_MBF, size);
+}
+
+/// Pass the reserved record to the reader
+osStatus osMsgBufCommit (osMsgBufId msgbuf_id, uint32_t size) {
+  P_MBF p_MBF = sysMsgBuf(msgbuf_id);
+
+  if (p_MBF == NULL) {
+    return osErrorParameter;
+  }
+  if (rt_mbf_commit(p_MBF, size) != OS_R_OK) {
+    return osErrorValue;                        // Nothing or less reserved
+  }
+  if (rt_mbf_due(p_MBF) != 0U) {
+    if (__get_IPSR() != 0U) {                   // in ISR
+      isr_mbf_wake(p_MBF);
+    } else {                                    // in Thread
+      __svcMsgBufWake(msgbuf_id);
+    }
+  }
+  return osOK;
+}
+
+/// Get the oldest record of a Message Buffer, wait for one if empty
+void *osMsgBufPeek (osMsgBufId msgbuf_id, uint32_t *size, uint32_t millisec) {
+  P_MBF p_MBF = sysMsgBuf(msgbuf_id);
+  void *data;
+
+  if ((p_MBF == NULL) || (size == NULL)) {
+    return NULL;
+  }
+  data = rt_mbf_peek(p_MBF, size);
+  if ((data == NULL) && (millisec != 0U) && (__get_IPSR() == 0U)) {
+    if (__svcMsgBufWait(msgbuf_id, 0U, 1U, millisec) == osOK) {
+      data = rt_mbf_peek(p_MBF, size);
+    }
+  }
+  return data;
+}
+
+/// Give the room of the oldest record back to the writer
+osStatus osMsgBufRelease (osMsgBufId msgbuf_id) {
+  P_MBF p_MBF = sysMsgBuf(msgbuf_id);
+
+  if (p_MBF == NULL) {
+    return osErrorParameter;
+  }
+  if (rt_mbf_release(p_MBF) != OS_R_OK) {
+    return osErrorResource;                     // Buffer is empty
+  }
+  return osOK;
+}
+
+/// Wait until a Message Buffer holds a number of bytes or records
+osStatus osMsgBufWait (osMsgBufId msgbuf_id, uint32_t bytes, uint32_t records, uint32_t millisec) {
+  if (__get_IPSR() != 0U) {
+    return osErrorISR;                          // Not allowed in ISR
+  }
+  if ((bytes == 0U) && (records == 0U)) {
+    return osErrorParameter;
+  }
+  return __svcMsgBufWait(msgbuf_id, bytes, records, millisec);
+}
+
+/// Get the bytes and records to be read from a Message Buffer
+uint32_t osMsgBufCount (osMsgBufId msgbuf_id, uint32_t *records) {
+  P_MBF p_MBF = sysMsgBuf(msgbuf_id);
+
+  if (p_MBF == NULL) {
+    return 0U;
+  }
+  return rt_mbf_count(p_MBF, records);
+}
+
+#endif
+
 
 //  ==== RTX Extensions ====
 
@@ -2187,3 +3533,215 @@ uint32_t os_suspend (void) {
 void os_resume (uint32_t sleep_time) {
   __rt_resume(sleep_time);
 }
+
+/// Get time spent asleep and awake
+uint32_t os_sleep_stat (uint32_t *asleep, uint32_t *awake) {
+  uint32_t sleep_ticks = os_sleep_ticks;
+
+  if (asleep != NULL) { *asleep = sleep_ticks; }
+  if (awake  != NULL) { *awake  = os_time - sleep_ticks; }
+  return os_sleep_cnt;
+}
+
+/// Get the ISR post service queue statistics
+uint32_t os_psq_stat (uint32_t *peak, uint32_t *merged, uint32_t *lost) {
+  if (peak   != NULL) { *peak   = os_psqs.peak;   }
+  if (merged != NULL) { *merged = os_psqs.merged; }
+  if (lost   != NULL) { *lost   = os_psqs.ovf;    }
+  return os_psqs.posts;
+}
+
+#ifdef CONFIG_RTX_CPU_STAT
+
+// CPU usage accounting
+
+// Service Calls declarations
+SVC_1_1(svcCpuCycles, uint32_t, osThreadId, RET_uint32_t)
+
+/// Get the cycles run by a thread, including its current time slice
+uint32_t svcCpuCycles (osThreadId thread_id) {
+  P_TCB ptcb;
+
+  ptcb = rt_tid2ptcb(thread_id);                // Get TCB pointer
+  if (ptcb == NULL) { return 0U; }
+
+  return rt_cpu_used(ptcb);
+}
+
+/// Share of the last load window in 0.01 %
+static uint32_t rt_cpu_share (uint32_t cycles) {
+  uint32_t win_len = os_cpu.win_len;
+
+  if (win_len == 0U) { return 0U; }
+  return (uint32_t)(((uint64_t)cycles * 10000U) / win_len);
+}
+
+// Public API
+
+/// Get the CPU cycles used by a thread
+uint32_t os_cpu_cycles (osThreadId thread_id) {
+  if (__get_IPSR() != 0U) {
+    return    svcCpuCycles(thread_id);          // Read directly in ISR
+  }
+  return    __svcCpuCycles(thread_id);
+}
+
+/// Get the CPU load of a thread in the last load window
+uint32_t os_cpu_load (osThreadId thread_id) {
+  P_TCB ptcb;
+
+  ptcb = rt_tid2ptcb(thread_id);                // Get TCB pointer
+  if (ptcb == NULL) { return 0U; }
+
+  return rt_cpu_share(ptcb->cpu_load);
+}
+
+/// Get the idle and interrupt load in the last load window
+uint32_t os_cpu_stat (uint32_t *idle, uint32_t *irq) {
+  if (idle != NULL) { *idle = rt_cpu_share(os_idle_TCB.cpu_load); }
+  if (irq  != NULL) { *irq  = rt_cpu_share(os_cpu.irq_load); }
+  return os_cpu.win_len;
+}
+
+#endif
+
+#if defined(CONFIG_RTX_CPU_STAT) || defined(CONFIG_RTX_TRACE)
+
+/// Count the time of an interrupt handler as interrupt time
+void os_irq_enter (void) {
+  uint32_t ipsr = __get_IPSR();
+
+  if (ipsr == 0U) { return; }                   // Only in ISR
+#ifdef CONFIG_RTX_TRACE
+  rt_trc_put(OS_TRC_IRQ_IN, 0U, ipsr);
+#endif
+#ifdef CONFIG_RTX_CPU_STAT
+  rt_cpu_irq_enter();
+#endif
+}
+
+/// End counting the time of an interrupt handler
+void os_irq_exit (void) {
+  uint32_t ipsr = __get_IPSR();
+
+  if (ipsr == 0U) { return; }                   // Only in ISR
+#ifdef CONFIG_RTX_CPU_STAT
+  rt_cpu_irq_exit();
+#endif
+#ifdef CONFIG_RTX_TRACE
+  rt_trc_put(OS_TRC_IRQ_OUT, 0U, ipsr);
+#endif
+}
+
+#endif
+
+#ifdef CONFIG_RTX_STK_WATERMARK
+
+// Stack high water marks
+
+// Service Calls declarations
+SVC_0_1(svcStackScan, uint32_t, RET_uint32_t)
+
+/// Scan the next few words of the stacks for the watermark
+uint32_t svcStackScan (void) {
+  return rt_stk_scan();
+}
+
+// Public API
+
+/// Move the stack watermark scan on by one step
+uint32_t os_stack_scan (void) {
+  if (__get_IPSR() != 0U) {
+    return    svcStackScan();                   // Scan directly in ISR
+  }
+  return    __svcStackScan();
+}
+
+/// Get the stack used by a thread, or by the main stack, at the last scan
+uint32_t os_stack_used (osThreadId thread_id, uint32_t *size) {
+  P_TCB    ptcb;
+  uint32_t stk_size, used;
+
+  ptcb = NULL;                                  // Main stack
+  if (thread_id != NULL) {
+    ptcb = rt_tid2ptcb(thread_id);              // Get TCB pointer
+    if (ptcb == NULL) {
+      if (size != NULL) { *size = 0U; }
+      return 0U;
+    }
+  }
+
+  used = rt_stk_used(ptcb, &stk_size);
+  if (size != NULL) { *size = stk_size; }
+  return used;
+}
+
+/// Scan all stacks and report their size and use
+void os_stack_report (void (*report)(osThreadId thread_id, uint32_t size, uint32_t used)) {
+  uint32_t i, stk_size, used, words;
+
+  while (os_stack_scan() == 0U);                // Finish the pass under way
+  while (os_stack_scan() == 0U);                // and make a full one
+
+  for (i = 0U; i < os_maxtaskrun; i++) {
+    if (os_active_TCB[i] != NULL) {
+      used = rt_stk_used(os_active_TCB[i], &stk_size);
+      report(os_active_TCB[i], stk_size, used);
+    }
+  }
+  used = rt_stk_used(&os_idle_TCB, &stk_size);
+  report(&os_idle_TCB, stk_size, used);
+  if (rt_msp_area(&words) != NULL) {
+    used = rt_stk_used(NULL, &stk_size);
+    report(NULL, stk_size, used);
+  }
+}
+
+#endif
+
+#ifdef CONFIG_RTX_TRACE
+
+// Kernel event trace
+
+#define OS_TRC_MAGIC    0x54585452U             // "RTXT"
+#define OS_TRC_VERSION  1U
+
+// Public API
+
+/// Fill the header of a trace dump
+uint32_t os_trace_header (uint32_t *buf) {
+  buf[0] = OS_TRC_MAGIC;
+  buf[1] = OS_TRC_VERSION | (sizeof(struct OS_TREC) << 16);
+  buf[2] = os_tickfreq;                         // Time stamp clock [Hz]
+  buf[3] = OS_TRC_SIZE;                         // Records in the ring
+  return 16U;
+}
+
+/// Move recorded events from the trace buffer
+uint32_t os_trace_read (uint32_t *buf, uint32_t size) {
+  uint32_t cnt;
+
+  cnt = rt_trc_read((P_TREC)buf, size / sizeof(struct OS_TREC));
+  return cnt * sizeof(struct OS_TREC);
+}
+
+#endif
+
+#ifdef CONFIG_RTX_STK_POOLS
+
+// Stack size class pools
+
+// Public API
+
+/// Get the use of a stack size class pool
+uint32_t os_stack_class_stat (uint32_t cls, uint32_t *blocks, uint32_t *used, uint32_t *peak, uint32_t *miss) {
+  if (cls >= OS_STKCLS_NUM) { return 0U; }
+
+  if (blocks != NULL) { *blocks = os_stkcls_info[cls] >> 16; }
+  if (used   != NULL) { *used   = os_stkcls[cls].used; }
+  if (peak   != NULL) { *peak   = os_stkcls[cls].peak; }
+  if (miss   != NULL) { *miss   = os_stkcls[cls].miss; }
+  return (uint16_t)os_stkcls_info[cls];
+}
+
+#endif
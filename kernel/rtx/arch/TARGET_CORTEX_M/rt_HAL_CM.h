@@ -172,6 +172,122 @@ static inline U8 __clz(U32 value)
 
 #endif
 
+#ifdef CONFIG_RTX_BASEPRI
+#if defined(__TARGET_ARCH_6S_M)
+#error "CONFIG_RTX_BASEPRI needs the BASEPRI register of ARMv7-M"
+#endif
+#if ((CONFIG_RTX_BASEPRI_LEVEL) < 0x01) || ((CONFIG_RTX_BASEPRI_LEVEL) > 0xFF)
+#error "CONFIG_RTX_BASEPRI_LEVEL must be a priority from 0x01 to 0xFF"
+#endif
+
+#if defined (__CC_ARM)
+
+__attribute__((always_inline)) static inline U32 rt_get_basepri (void) {
+  register U32 basepri __asm("basepri");
+  return (basepri);
+}
+
+__attribute__((always_inline)) static inline void rt_set_basepri (U32 value) {
+  register U32 basepri __asm("basepri");
+  __schedule_barrier();
+  basepri = value;
+  __schedule_barrier();
+}
+
+__attribute__((always_inline)) static inline void rt_max_basepri (U32 value) {
+  register U32 basepri_max __asm("basepri_max");
+  __schedule_barrier();
+  basepri_max = value;
+  __isb(0xF);
+  __schedule_barrier();
+}
+
+#else
+
+__attribute__((always_inline)) static inline U32 rt_get_basepri (void) {
+  U32 result;
+
+  __asm volatile ("mrs %0, basepri" : "=r" (result));
+  return (result);
+}
+
+__attribute__((always_inline)) static inline void rt_set_basepri (U32 value) {
+  __asm volatile ("msr basepri, %0" : : "r" (value) : "memory");
+}
+
+__attribute__((always_inline)) static inline void rt_max_basepri (U32 value) {
+  __asm volatile ("msr basepri_max, %0\n\tisb" : : "r" (value) : "memory");
+}
+
+#endif
+#endif
+
+#ifdef CONFIG_RTX_FAST_SYNC
+#if defined(__TARGET_ARCH_6S_M)
+#error "CONFIG_RTX_FAST_SYNC needs the exclusive access instructions of ARMv7-M"
+#endif
+
+/* Exclusive access for the thread mode fast paths. Exception entry and */
+/* return clear the monitor, so a store fails when the kernel ran since */
+/* the load.                                                             */
+#if defined (__CC_ARM)
+
+#define rt_ldrex_w(p)   __ldrex((volatile U32 *)(p))
+#define rt_strex_w(v,p) __strex((U32)(v), (volatile U32 *)(p))
+#define rt_ldrex_h(p)   __ldrex((volatile U16 *)(p))
+#define rt_strex_h(v,p) __strex((U16)(v), (volatile U16 *)(p))
+#define rt_clrex()      __clrex()
+
+#elif defined (__ICCARM__)
+
+#include <intrinsics.h>
+
+#define rt_ldrex_w(p)   __LDREX((unsigned long *)(p))
+#define rt_strex_w(v,p) __STREX((unsigned long)(v), (unsigned long *)(p))
+#define rt_ldrex_h(p)   __LDREXH((unsigned short *)(p))
+#define rt_strex_h(v,p) __STREXH((unsigned short)(v), (unsigned short *)(p))
+#define rt_clrex()      __CLREX()
+
+#else
+
+__attribute__((always_inline)) static inline U32 rt_ldrex_w (volatile U32 *p) {
+  U32 result;
+
+  __asm volatile ("ldrex %0, %1" : "=r" (result) : "Q" (*p));
+  return (result);
+}
+
+__attribute__((always_inline)) static inline U32 rt_strex_w (U32 val, volatile U32 *p) {
+  U32 result;
+
+  __asm volatile ("strex %0, %2, %1" : "=&r" (result), "=Q" (*p) : "r" (val) : "memory");
+  return (result);
+}
+
+__attribute__((always_inline)) static inline U32 rt_ldrex_h (volatile U16 *p) {
+  U32 result;
+
+  __asm volatile ("ldrexh %0, %1" : "=r" (result) : "Q" (*p));
+  return (result);
+}
+
+__attribute__((always_inline)) static inline U32 rt_strex_h (U32 val, volatile U16 *p) {
+  U32 result;
+
+  __asm volatile ("strexh %0, %2, %1" : "=&r" (result), "=Q" (*p) : "r" (val) : "memory");
+  return (result);
+}
+
+__attribute__((always_inline)) static inline void rt_clrex (void) {
+  __asm volatile ("clrex" : : : "memory");
+}
+
+#endif
+
+#define rt_ldrex_p(p)   ((void *)rt_ldrex_w ((volatile U32 *)(p)))
+#define rt_strex_p(v,p) rt_strex_w ((U32)(v), (volatile U32 *)(p))
+#endif
+
 /* NVIC registers */
 #define NVIC_ST_CTRL    (*((volatile U32 *)0xE000E010U))
 #define NVIC_ST_RELOAD  (*((volatile U32 *)0xE000E014U))
@@ -223,29 +339,53 @@ static inline U8 __clz(U32 value)
 extern BIT dbg_msg;
 
 /* Functions */
+
+/* Kernel critical sections, nest and return the mask to restore */
+#ifdef CONFIG_RTX_BASEPRI
+#define OS_BASEPRI      ((U32)(CONFIG_RTX_BASEPRI_LEVEL))
+
+__inline static U32 rt_irq_lock (void) {
+  /* Mask the interrupts that may call the kernel, higher ones still run. */
+  U32 basepri = rt_get_basepri ();
+  rt_max_basepri (OS_BASEPRI);
+  return (basepri);
+}
+
+__inline static void rt_irq_unlock (U32 basepri) {
+  rt_set_basepri (basepri);
+}
+#else
+__inline static U32 rt_irq_lock (void) {
+  /* Mask all interrupts. */
+  U32 primask = __get_PRIMASK();
+  __disable_irq();
+  return (primask);
+}
+
+__inline static void rt_irq_unlock (U32 primask) {
+  if (!primask) {
+    __enable_irq ();
+  }
+}
+#endif
+
 #ifdef __USE_EXCLUSIVE_ACCESS
  #define rt_inc(p)     while(__strex((__ldrex(p)+1U),p))
  #define rt_dec(p)     while(__strex((__ldrex(p)-1U),p))
 #else
  #define rt_inc(p) do {\
-                     U32 primask = __get_PRIMASK();\
-                     __disable_irq();\
+                     U32 lock = rt_irq_lock();\
                      (*p)++;\
-                     if (!primask) {\
-                       __enable_irq();\
-                     }\
+                     rt_irq_unlock(lock);\
                    } while (0)
  #define rt_dec(p) do {\
-                     U32 primask = __get_PRIMASK();\
-                     __disable_irq();\
+                     U32 lock = rt_irq_lock();\
                      (*p)--;\
-                     if (!primask) {\
-                       __enable_irq();\
-                     }\
+                     rt_irq_unlock(lock);\
                    } while (0)
 #endif
 
-__inline static U32 rt_inc_qi (U32 size, U8 *count, U8 *first) {
+__inline static U32 rt_inc_qi (U32 size, U16 *count, U16 *first) {
   U32 cnt,c2;
 #ifdef __USE_EXCLUSIVE_ACCESS
   do {
@@ -258,21 +398,113 @@ __inline static U32 rt_inc_qi (U32 size, U8 *count, U8 *first) {
     if (c2 == size) { c2 = 0U; }
   } while (__strex(c2, first));
 #else
-  U32 primask = __get_PRIMASK();
-  __disable_irq();
+  U32 lock = rt_irq_lock();
   if ((cnt = *count) < size) {
-    *count = (U8)(cnt+1U);
+    *count = (U16)(cnt+1U);
     c2 = (cnt = *first) + 1U;
     if (c2 == size) { c2 = 0U; }
-    *first = (U8)c2; 
-  }
-  if (!primask) {
-    __enable_irq ();
+    *first = (U16)c2; 
   }
+  rt_irq_unlock (lock);
 #endif
   return (cnt);
 }
 
+__inline static U32 rt_add_qi (U32 size, U16 *count, U16 *first, U32 n) {
+  /* Take "n" entries at once, return the index of the first one or "size" */
+  /* when they do not fit.                                                  */
+  U32 cnt,idx,c2;
+#ifdef __USE_EXCLUSIVE_ACCESS
+  do {
+    if (((cnt = __ldrex(count)) + n) > size) {
+      __clrex();
+      return (size); }
+  } while (__strex(cnt+n, count));
+  do {
+    c2 = (idx = __ldrex(first)) + n;
+    if (c2 >= size) { c2 -= size; }
+  } while (__strex(c2, first));
+#else
+  U32 lock = rt_irq_lock();
+  if (((cnt = *count) + n) > size) {
+    idx = size;
+  }
+  else {
+    *count = (U16)(cnt+n);
+    c2 = (idx = *first) + n;
+    if (c2 >= size) { c2 -= size; }
+    *first = (U16)c2;
+  }
+  rt_irq_unlock (lock);
+#endif
+  return (idx);
+}
+
+__inline static U32 rt_fetch_inc (U32 *p) {
+  /* Increment "*p" atomically, return its value before. */
+  U32 val;
+#ifdef __USE_EXCLUSIVE_ACCESS
+  do {
+    val = __ldrex(p);
+  } while (__strex(val+1U, p));
+#else
+  U32 lock = rt_irq_lock();
+  val = (*p)++;
+  rt_irq_unlock (lock);
+#endif
+  return (val);
+}
+
+#ifdef CONFIG_RTX_PSQ_COALESCE
+__inline static U32 rt_fetch_or16 (U16 *p, U32 val) {
+  /* Set bits "val" in "*p" atomically, return its value before. */
+  U32 old;
+#ifdef __USE_EXCLUSIVE_ACCESS
+  do {
+    old = __ldrex(p);
+  } while (__strex((U16)(old|val), p));
+#else
+  U32 lock = rt_irq_lock();
+  old = *p;
+  *p  = (U16)(old|val);
+  rt_irq_unlock (lock);
+#endif
+  return (old);
+}
+
+__inline static U32 rt_fetch_inc16 (U16 *p) {
+  /* Increment "*p" atomically, return its value before. */
+  U32 old;
+#ifdef __USE_EXCLUSIVE_ACCESS
+  do {
+    old = __ldrex(p);
+  } while (__strex((U16)(old+1U), p));
+#else
+  U32 lock = rt_irq_lock();
+  old = *p;
+  *p  = (U16)(old+1U);
+  rt_irq_unlock (lock);
+#endif
+  return (old);
+}
+
+__inline static U32 rt_swap16 (U16 *p, U32 val) {
+  /* Write "val" to "*p" atomically, return its value before. */
+  U32 old;
+#ifdef __USE_EXCLUSIVE_ACCESS
+  do {
+    old = __ldrex(p);
+  } while (__strex((U16)val, p));
+#else
+  U32 lock = rt_irq_lock();
+  old = *p;
+  *p  = (U16)val;
+  rt_irq_unlock (lock);
+#endif
+  return (old);
+}
+#endif
+
 __inline static void rt_systick_init (void) {
   NVIC_ST_RELOAD  = os_trv;
   NVIC_ST_CURRENT = 0U;
@@ -288,6 +520,110 @@ __inline static U32 rt_systick_ovf (void) {
   return ((NVIC_INT_CTRL >> 26) & 1U);
 }
 
+#if defined(CONFIG_RTX_CPU_STAT) || defined(CONFIG_RTX_TRACE) || defined(CONFIG_RTX_CLOCK64)
+#if defined(__TARGET_ARCH_6S_M)
+#error "CONFIG_RTX_CPU_STAT, CONFIG_RTX_TRACE and CONFIG_RTX_CLOCK64 need the DWT cycle counter of ARMv7-M"
+#endif
+#define DBG_DEMCR       (*((volatile U32 *)0xE000EDFCU))
+#define DWT_CTRL        (*((volatile U32 *)0xE0001000U))
+#define DWT_CYCCNT      (*((volatile U32 *)0xE0001004U))
+
+__inline static void rt_cpu_start (void) {
+  DBG_DEMCR |= 0x01000000U;             /* TRCENA: enable DWT               */
+  DWT_CTRL  |= 0x00000001U;             /* CYCCNTENA: run cycle counter     */
+}
+
+__inline static U32 rt_cpu_cycles (void) {
+  return (DWT_CYCCNT);
+}
+#endif
+
+__inline static U32 rt_msb (U32 value) {
+  /* Return index of the most significant bit set in non-zero "value". */
+#if defined(__TARGET_ARCH_6S_M)
+  U32 n = 0U;
+  if (value & 0xFFFF0000U) { value >>= 16; n += 16U; }
+  if (value & 0x0000FF00U) { value >>=  8; n +=  8U; }
+  if (value & 0x000000F0U) { value >>=  4; n +=  4U; }
+  if (value & 0x0000000CU) { value >>=  2; n +=  2U; }
+  if (value & 0x00000002U) {               n +=  1U; }
+  return (n);
+#else
+  return (31U - __clz(value));
+#endif
+}
+
+#if defined (__CC_ARM)
+#define rt_wfi()        __wfi()
+#else
+#define rt_wfi()        __asm volatile ("wfi")
+#endif
+
+__inline static U32 rt_systick_sleep (U32 ticks) {
+  /* Run SysTick as a one-shot timer "ticks" away and wait for interrupt.   */
+  U32 tick,left,load,elapsed,slept,lock;
+
+  tick = os_trv + 1U;
+  if (ticks > (0x01000000U / tick)) {
+    /* SysTick is a 24-bit down counter */
+    ticks = 0x01000000U / tick;
+  }
+  if (ticks < 2U) {
+    return (0U);
+  }
+  lock = rt_irq_lock ();
+  left = NVIC_ST_CURRENT;
+  load = left + ((ticks - 1U) * tick) - 1U;
+  NVIC_ST_CTRL    = 0x0004U;
+  NVIC_ST_RELOAD  = load;
+  NVIC_ST_CURRENT = 0U;
+  NVIC_ST_CTRL    = 0x0007U;
+
+#ifdef CONFIG_RTX_BASEPRI
+  /* WFI ignores interrupts masked by BASEPRI, wait with PRIMASK only */
+  __disable_irq ();
+  rt_irq_unlock (lock);
+  rt_wfi ();
+  lock = rt_irq_lock ();
+  __enable_irq ();
+#else
+  rt_wfi ();
+#endif
+
+  /* Woken by the one-shot or by another interrupt */
+  if (NVIC_ST_CTRL & 0x00010000U) {
+    elapsed = load + 1U + (load - NVIC_ST_CURRENT);
+  }
+  else {
+    elapsed = load - NVIC_ST_CURRENT;
+  }
+  if (elapsed < left) {
+    slept = 0U;
+    left -= elapsed;
+  }
+  else {
+    elapsed -= left;
+    slept = (elapsed / tick) + 1U;
+    left  = tick - (elapsed % tick);
+  }
+  if (left < 2U) {
+    /* Next tick is due right now, account it to the sleep */
+    left += tick;
+    slept++;
+  }
+
+  /* Restart periodic ticks in phase with the sleep */
+  NVIC_ST_CTRL    = 0x0004U;
+  NVIC_ST_RELOAD  = left - 1U;
+  NVIC_ST_CURRENT = 0U;
+  NVIC_ST_CTRL    = 0x0005U;
+  while (NVIC_ST_CURRENT == 0U);
+  NVIC_ST_RELOAD  = os_trv;
+  NVIC_INT_CTRL   = (1UL<<25);
+  rt_irq_unlock (lock);
+  return (slept);
+}
+
 __inline static void rt_svc_init (void) {
 #if !defined(__TARGET_ARCH_6S_M)
   U32 sh,prigroup;
@@ -316,6 +652,10 @@ extern void *_alloc_box (void *box_mem);
 extern U32  _free_box (void *box_mem, void *box);
 
 extern void rt_init_stack (P_TCB p_TCB, FUNCP task_body);
+#ifdef CONFIG_RTX_STK_WATERMARK
+extern U32  *rt_msp_area (U32 *words);
+extern void rt_msp_fill  (void);
+#endif
 extern void rt_ret_val  (P_TCB p_TCB, U32 v0);
 extern void rt_ret_val2 (P_TCB p_TCB, U32 v0, U32 v1);
 
@@ -0,0 +1,476 @@
+/*----------------------------------------------------------------------------
+ *      CMSIS-RTOS  -  RTX
+ *----------------------------------------------------------------------------
+ *      Name:    HAL_POSIX.C
+ *      Purpose: Hardware Abstraction Layer for the POSIX host port
+ *      Rev.:    V4.79
+ *----------------------------------------------------------------------------
+ *
+ * Everything runs in one host thread. SVC calls run the kernel function in
+ * place with IPSR set, PendSV and SysTick are pending bits taken whenever
+ * the code returns to thread mode with interrupts enabled, and a periodic
+ * SIGALRM pends SysTick. Thread switches are swapcontext() calls made at
+ * those exception returns, so a thread may be switched out from inside the
+ * SIGALRM handler exactly as a Cortex-M thread is preempted by SysTick.
+ *
+ * Host libc is not reentrant across threads preempted by the tick, keep
+ * stdio to one thread or guard it with a mutex.
+ *---------------------------------------------------------------------------*/
+
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_System.h"
+#include "rt_Task.h"
+#include "rt_MemBox.h"
+#include "rt_HAL_CM.h"
+
+/* After the kernel headers, the libc ones replace their NULL */
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+/*----------------------------------------------------------------------------
+ *      Definitions
+ *---------------------------------------------------------------------------*/
+
+/* Saved context at the top of each thread stack. The emulated exception  */
+/* frame keeps R0-R3 and LR where rt_ret_val() and the CMSIS layer expect */
+/* them (tsk_stack + 8 and + 13 words at thread creation).                */
+typedef struct OS_CTX {
+  U32        frame[16];           /* R4-R11,R0-R3,R12,LR,PC,xPSR            */
+  ucontext_t uc;                  /* Host context of the thread             */
+} OS_CTX;
+
+#define CTX_R0          8U
+#define CTX_LR          13U
+#define CTX_PC          14U
+#define CTX_xPSR        15U
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+volatile U32 os_primask;
+volatile U32 os_ipsr;
+volatile U32 os_control;
+volatile U32 os_pend;
+volatile U32 os_tick_on;
+#ifdef CONFIG_RTX_FAST_SYNC
+volatile void *volatile os_excl;
+#endif
+
+static U32 os_ctx_drop;           /* Context of running thread abandoned    */
+static U64 os_tick_ns;            /* Tick period [ns]                       */
+static U64 os_tick_base;          /* Host time of tick 0 [ns]               */
+static volatile U32 os_tick_cnt;  /* Tick periods elapsed since tick 0      */
+
+/*----------------------------------------------------------------------------
+ *      Local Functions
+ *---------------------------------------------------------------------------*/
+
+static U64 rt_time_ns (void) {
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ((U64)ts.tv_sec * 1000000000U + (U64)ts.tv_nsec);
+}
+
+static void rt_timer_arm (U64 value, U64 interval) {
+  /* Program ITIMER_REAL, "value" 0 disarms it. */
+  struct itimerval it;
+
+  it.it_value.tv_sec     = (time_t)(value / 1000000000U);
+  it.it_value.tv_usec    = (suseconds_t)((value % 1000000000U) / 1000U);
+  it.it_interval.tv_sec  = (time_t)(interval / 1000000000U);
+  it.it_interval.tv_usec = (suseconds_t)((interval % 1000000000U) / 1000U);
+  if ((value != 0U) && (it.it_value.tv_sec == 0) && (it.it_value.tv_usec == 0)) {
+    it.it_value.tv_usec = 1;
+  }
+  setitimer (ITIMER_REAL, &it, NULL);
+}
+
+static OS_CTX *rt_ctx (P_TCB p_TCB) {
+  /* Saved context at the top of the stack of "p_TCB". */
+  U32 size;
+
+  size = p_TCB->priv_stack;
+  if (size == 0U) {
+    size = (U16)os_stackinfo;
+  }
+  return ((OS_CTX *)(((uintptr_t)p_TCB->stack + size - sizeof(OS_CTX)) &
+                     ~(uintptr_t)15U));
+}
+
+static void rt_switch (void) {
+  /* Switch from os_tsk.run to os_tsk.next on exception return. */
+  P_TCB p_run, p_next;
+
+  p_run  = os_tsk.run;
+  p_next = os_tsk.next;
+  if (p_run == p_next) {
+    return;
+  }
+  if ((p_run == NULL) || (os_ctx_drop != 0U)) {
+    /* Running task deleted or replaced at kernel start: nothing to save */
+    os_ctx_drop = 0U;
+    os_tsk.run  = p_next;
+    setcontext (&rt_ctx (p_next)->uc);
+  }
+  p_run->tsk_stack = rt_get_PSP ();
+  rt_stk_check ();
+  os_tsk.run = p_next;
+  swapcontext (&rt_ctx (p_run)->uc, &rt_ctx (p_next)->uc);
+}
+
+static void rt_irq_return (void) {
+  /* Return to thread mode, take what got pending meanwhile. */
+  os_ipsr = 0U;
+  if ((os_pend != 0U) && (os_primask == 0U)) {
+    rt_irq_take ();
+  }
+}
+
+static void rt_task_start (void) {
+  /* First run of a task: call its body with R0, then return to LR. */
+  OS_CTX *ctx;
+  U32 pc,r0,lr;
+
+  ctx = rt_ctx (os_tsk.run);
+  pc  = ctx->frame[CTX_PC];
+  r0  = ctx->frame[CTX_R0];
+  lr  = ctx->frame[CTX_LR];
+  rt_irq_return ();
+  ((void (*)(void *))pc) ((void *)r0);
+  if (lr == 0U) {
+    /* No return address, a Cortex-M would fault here. */
+    abort ();
+  }
+  ((void (*)(void))lr) ();
+  abort ();
+}
+
+static void rt_sig_tick (int sig) {
+  /* SIGALRM: the SysTick counter wrapped. */
+  int err;
+  U64 now;
+
+  (void)sig;
+  err = errno;
+  now = rt_time_ns ();
+  os_tick_cnt = (U32)((now - os_tick_base) / os_tick_ns);
+  if (os_tick_on != 0U) {
+    __atomic_or_fetch (&os_pend, OS_PEND_ST, __ATOMIC_SEQ_CST);
+  }
+  if ((os_ipsr == 0U) && (os_primask == 0U)) {
+    rt_irq_take ();
+  }
+  errno = err;
+}
+
+/*----------------------------------------------------------------------------
+ *      Functions
+ *---------------------------------------------------------------------------*/
+
+
+/*--------------------------- rt_irq_take -----------------------------------*/
+
+void rt_irq_take (void) {
+  /* Take pending PendSV and SysTick exceptions, switching tasks after each */
+  U32 pend;
+
+#ifdef CONFIG_RTX_FAST_SYNC
+  os_excl = NULL;
+#endif
+  do {
+    os_ipsr = OS_IPSR_PENDSV;
+    while ((pend = os_pend) != 0U) {
+      if (pend & OS_PEND_SV) {
+        __atomic_and_fetch (&os_pend, ~OS_PEND_SV, __ATOMIC_SEQ_CST);
+        rt_pop_req ();
+      }
+      else {
+        os_ipsr = OS_IPSR_SYSTICK;
+        __atomic_and_fetch (&os_pend, ~OS_PEND_ST, __ATOMIC_SEQ_CST);
+        rt_systick ();
+      }
+      rt_switch ();
+      os_ipsr = OS_IPSR_PENDSV;
+    }
+    os_ipsr = 0U;
+  } while ((os_pend != 0U) && (os_primask == 0U));
+}
+
+
+/*--------------------------- rt_irq_pend -----------------------------------*/
+
+void rt_irq_pend (U32 flags) {
+  /* Set pending exceptions, taken at once from thread mode. */
+  __atomic_or_fetch (&os_pend, flags, __ATOMIC_SEQ_CST);
+  if ((os_pend != 0U) && (os_ipsr == 0U) && (os_primask == 0U)) {
+    rt_irq_take ();
+  }
+}
+
+
+/*--------------------------- rt_irq_unpend ---------------------------------*/
+
+U32 rt_irq_unpend (U32 flags) {
+  /* Clear pending exceptions, return the ones that were pending. */
+  return (__atomic_fetch_and (&os_pend, ~flags, __ATOMIC_SEQ_CST) & flags);
+}
+
+
+/*--------------------------- rt_irq_wait -----------------------------------*/
+
+void rt_irq_wait (void) {
+  /* Wait for interrupt: sleep until the next signal. */
+  sigset_t set,old;
+
+  sigemptyset (&set);
+  sigaddset (&set, SIGALRM);
+  sigprocmask (SIG_BLOCK, &set, &old);
+  if (os_pend == 0U) {
+    sigsuspend (&old);
+  }
+  sigprocmask (SIG_SETMASK, &old, NULL);
+}
+
+
+/*--------------------------- rt_irq_run ------------------------------------*/
+
+void rt_irq_run (void (*isr)(void)) {
+  /* Run "isr" as an external interrupt handler, then return to thread mode */
+  /* through the pending exceptions it left, as the tail chain on target.   */
+  U32 ipsr;
+
+#ifdef CONFIG_RTX_FAST_SYNC
+  os_excl = NULL;
+#endif
+  ipsr = os_ipsr;
+  os_ipsr = OS_IPSR_IRQ;
+  isr ();
+  os_ipsr = ipsr;
+  if ((os_pend != 0U) && (os_ipsr == 0U) && (os_primask == 0U)) {
+    rt_irq_take ();
+  }
+}
+
+
+/*--------------------------- rt_svc_enter ----------------------------------*/
+
+U32 *rt_svc_enter (void) {
+  /* Enter SVC, return the R0-R3 frame for the results of the caller. */
+#ifdef CONFIG_RTX_FAST_SYNC
+  os_excl = NULL;
+#endif
+  os_ipsr = OS_IPSR_SVC;
+  return (&rt_ctx (os_tsk.run)->frame[CTX_R0]);
+}
+
+
+/*--------------------------- rt_svc_exit -----------------------------------*/
+
+void rt_svc_exit (void) {
+  /* Leave SVC, switch task if the service call asked for it. */
+  rt_switch ();
+  rt_irq_return ();
+}
+
+
+/*--------------------------- rt_set_PSP ------------------------------------*/
+
+void rt_set_PSP (U32 stack) {
+  /* Only used to discard the caller context when the kernel starts. */
+  (void)stack;
+  os_ctx_drop = 1U;
+}
+
+
+/*--------------------------- rt_get_PSP ------------------------------------*/
+
+U32 rt_get_PSP (void) {
+  U32 sp;
+
+  sp = (U32)(uintptr_t)&sp;
+  return (sp);
+}
+
+
+/*--------------------------- _alloc_box -----------------------------------*/
+
+void *_alloc_box (void *box_mem) {
+  /* All threads run privileged on the host. */
+  return (rt_alloc_box (box_mem));
+}
+
+
+/*--------------------------- _free_box -------------------------------------*/
+
+U32 _free_box (void *box_mem, void *box) {
+  return (rt_free_box (box_mem, box));
+}
+
+
+/*--------------------------- rt_systick_init -------------------------------*/
+
+void rt_systick_init (void) {
+  /* Start the periodic SIGALRM emulating SysTick. */
+  struct sigaction sa;
+
+  os_tick_ns   = (U64)os_clockrate * 1000U;
+  os_tick_base = rt_time_ns ();
+  os_tick_cnt  = 0U;
+  os_tick_on   = 1U;
+
+  memset (&sa, 0, sizeof(sa));
+  sa.sa_handler = rt_sig_tick;
+  sigemptyset (&sa.sa_mask);
+  sa.sa_flags = SA_RESTART;
+  sigaction (SIGALRM, &sa, NULL);
+
+  rt_timer_arm (os_tick_ns, os_tick_ns);
+}
+
+
+/*--------------------------- rt_systick_val --------------------------------*/
+
+U32 rt_systick_val (void) {
+  /* Counts since the last tick (0 .. os_trv). */
+  U64 ns;
+
+  ns = (rt_time_ns () - os_tick_base) % os_tick_ns;
+  return ((U32)((ns * ((U64)os_trv + 1U)) / os_tick_ns));
+}
+
+
+/*--------------------------- rt_systick_ovf --------------------------------*/
+
+U32 rt_systick_ovf (void) {
+  /* A tick is pending or its period ended before SIGALRM came in. The    */
+  /* pending flag is checked last: a SIGALRM in between sets both.        */
+  U32 cnt;
+
+  cnt = (U32)((rt_time_ns () - os_tick_base) / os_tick_ns);
+  if (cnt != os_tick_cnt) {
+    return (1U);
+  }
+  return ((os_pend & OS_PEND_ST) ? 1U : 0U);
+}
+
+
+/*--------------------------- rt_systick_sleep ------------------------------*/
+
+U32 rt_systick_sleep (U32 ticks) {
+  /* Run the interval timer as a one-shot "ticks" periods away and wait */
+  /* for a signal. Return the elapsed ticks with periodic ticks running  */
+  /* in phase again and the tick interrupt still locked.                 */
+  sigset_t set,old;
+  U64 now,next;
+  U32 cnt,slept;
+
+  if (ticks < 2U) {
+    return (0U);
+  }
+  sigemptyset (&set);
+  sigaddset (&set, SIGALRM);
+  sigprocmask (SIG_BLOCK, &set, &old);
+  __disable_irq ();
+
+  now  = rt_time_ns ();
+  cnt  = (U32)((now - os_tick_base) / os_tick_ns);
+  next = os_tick_base + ((U64)cnt + ticks) * os_tick_ns;
+  rt_timer_arm (next - now, 0U);
+
+  sigsuspend (&old);
+
+  /* Woken by the one-shot or by another signal */
+  now   = rt_time_ns ();
+  slept = (U32)((now - os_tick_base) / os_tick_ns) - cnt;
+  os_tick_cnt = cnt + slept;
+
+  /* Restart periodic ticks in phase with the sleep */
+  next = os_tick_base + ((U64)os_tick_cnt + 1U) * os_tick_ns;
+  rt_timer_arm (next - now, os_tick_ns);
+
+  sigprocmask (SIG_SETMASK, &old, NULL);
+  __enable_irq ();
+  return (slept);
+}
+
+
+/*--------------------------- rt_cpu_cycles ---------------------------------*/
+
+U32 rt_cpu_cycles (void) {
+  /* Free running cycle counter: nanoseconds of the monotonic clock. */
+  return ((U32)rt_time_ns ());
+}
+
+
+/*--------------------------- rt_init_stack ---------------------------------*/
+
+void rt_init_stack (P_TCB p_TCB, FUNCP task_body) {
+  /* Prepare TCB and saved context for a first time start of a task. */
+  OS_CTX *ctx;
+  U32 *stk,i;
+
+  ctx = rt_ctx (p_TCB);
+
+  /* Emulated frame: PC is the task entry, R0 its argument. */
+  for (i = 0U; i < 16U; i++) {
+    ctx->frame[i] = 0U;
+  }
+  ctx->frame[CTX_xPSR] = INITIAL_xPSR;
+  ctx->frame[CTX_PC]   = (U32)(uintptr_t)task_body;
+  ctx->frame[CTX_R0]   = (U32)(uintptr_t)p_TCB->msg;
+
+  /* Host context starts in rt_task_start on the rest of the stack. */
+  getcontext (&ctx->uc);
+  ctx->uc.uc_stack.ss_sp   = p_TCB->stack;
+  ctx->uc.uc_stack.ss_size = (size_t)((U8 *)ctx - (U8 *)p_TCB->stack);
+  ctx->uc.uc_link          = NULL;
+  sigemptyset (&ctx->uc.uc_sigmask);
+  makecontext (&ctx->uc, rt_task_start, 0);
+
+  /* Initial Task stack pointer. */
+  p_TCB->tsk_stack = (U32)(uintptr_t)ctx;
+
+  /* Task entry point. */
+  p_TCB->ptask = task_body;
+
+  /* Initialize stack with magic pattern. */
+  if (os_stackinfo & 0x10000000U) {
+    for (stk = (U32 *)ctx - 1; stk > p_TCB->stack; stk--) {
+      *stk = MAGIC_PATTERN;
+    }
+  }
+
+  /* Set a magic word for checking of stack overflow. */
+  p_TCB->stack[0] = MAGIC_WORD;
+}
+
+
+/*--------------------------- rt_ret_val ----------------------------------*/
+
+void rt_ret_val (P_TCB p_TCB, U32 v0) {
+  OS_CTX *ctx;
+
+  ctx = rt_ctx (p_TCB);
+  ctx->frame[CTX_R0] = v0;
+}
+
+void rt_ret_val2(P_TCB p_TCB, U32 v0, U32 v1) {
+  OS_CTX *ctx;
+
+  ctx = rt_ctx (p_TCB);
+  ctx->frame[CTX_R0]      = v0;
+  ctx->frame[CTX_R0 + 1U] = v1;
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
@@ -0,0 +1,300 @@
+/*----------------------------------------------------------------------------
+ *      CMSIS-RTOS  -  RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RTX_Conf_POSIX.C
+ *      Purpose: Configuration of CMSIS RTX Kernel for the POSIX host port
+ *      Rev.:    V4.70.1
+ *----------------------------------------------------------------------------
+ *
+ * Same options as RTX_Conf_CM.c. Thread stacks also hold the host signal
+ * frames and libc calls, so the defaults are much larger than on target.
+ *---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cmsis_os.h"
+
+
+/*----------------------------------------------------------------------------
+ *      RTX User configuration part BEGIN
+ *---------------------------------------------------------------------------*/
+
+// <h>Thread Configuration
+// =======================
+//
+//   <o>Number of concurrent running user threads <1-250>
+//   <i> Defines max. number of user threads that will run at the same time.
+//   <i> Default: 14
+#ifndef OS_TASKCNT
+ #define OS_TASKCNT     14
+#endif
+
+//   <o>Default Thread stack size [bytes] <16384-65528:8><#/4>
+//   <i> Defines default stack size for threads with osThreadDef stacksz = 0
+//   <i> Default: 16384
+#ifndef OS_STKSIZE
+ #define OS_STKSIZE     4096    // this stack size value is in words
+#endif
+
+//   <o>Main Thread stack size [bytes] <16384-65528:8><#/4>
+//   <i> Defines stack size for main thread.
+//   <i> Default: 32768
+#ifndef OS_MAINSTKSIZE
+ #define OS_MAINSTKSIZE 8192    // this stack size value is in words
+#endif
+
+//   <o>Number of threads with user-provided stack size <0-250>
+//   <i> Defines the number of threads with user-provided stack size.
+//   <i> Default: 0
+#ifndef OS_PRIVCNT
+ #define OS_PRIVCNT     0
+#endif
+
+//   <o>Total stack size [bytes] for threads with user-provided stack size <0-1048576:8><#/4>
+//   <i> Defines the combined stack size for threads with user-provided stack size.
+//   <i> Default: 0
+#ifndef OS_PRIVSTKSIZE
+ #define OS_PRIVSTKSIZE 0       // this stack size value is in words
+#endif
+
+//   <h>Stack size classes (CONFIG_RTX_STK_POOLS)
+//   <i> Threads with user-provided stack size take the smallest block that fits
+//   <i> from these pools, before the user-provided stack area. Block sizes must
+//   <i> ascend, blocks count as threads with user-provided stack size.
+//     <o>Class 0 block size [bytes] <8-65528:8>
+#ifndef OS_STKCLS0_SIZE
+ #define OS_STKCLS0_SIZE 8192
+#endif
+//     <o>Class 0 blocks <0-250>
+#ifndef OS_STKCLS0_CNT
+ #define OS_STKCLS0_CNT  2
+#endif
+//     <o>Class 1 block size [bytes] <8-65528:8>
+#ifndef OS_STKCLS1_SIZE
+ #define OS_STKCLS1_SIZE 16384
+#endif
+//     <o>Class 1 blocks <0-250>
+#ifndef OS_STKCLS1_CNT
+ #define OS_STKCLS1_CNT  1
+#endif
+//     <o>Class 2 block size [bytes] <8-65528:8>
+#ifndef OS_STKCLS2_SIZE
+ #define OS_STKCLS2_SIZE 32768
+#endif
+//     <o>Class 2 blocks <0-250>
+#ifndef OS_STKCLS2_CNT
+ #define OS_STKCLS2_CNT  0
+#endif
+//     <o>Class 3 block size [bytes] <8-65528:8>
+#ifndef OS_STKCLS3_SIZE
+ #define OS_STKCLS3_SIZE 65528
+#endif
+//     <o>Class 3 blocks <0-250>
+#ifndef OS_STKCLS3_CNT
+ #define OS_STKCLS3_CNT  1
+#endif
+//   </h>
+
+//   <q>Stack overflow checking
+//   <i> Enable stack overflow checks at thread switch.
+#ifndef OS_STKCHECK
+ #define OS_STKCHECK    1
+#endif
+
+//   <q>Stack usage watermark
+//   <i> Initialize thread stack with watermark pattern for analyzing stack usage.
+#ifndef OS_STKINIT
+#define OS_STKINIT      0
+#endif
+#ifdef CONFIG_RTX_STK_WATERMARK
+// Stack high water marks are read back from the pattern
+#undef  OS_STKINIT
+#define OS_STKINIT      1
+#endif
+
+//   <o>Processor mode for thread execution
+//     <0=> Unprivileged mode
+//     <1=> Privileged mode
+//   <i> Default: Privileged mode
+#ifndef OS_RUNPRIV
+ #define OS_RUNPRIV     1
+#endif
+
+// </h>
+
+// <h>RTX Kernel Timer Tick Configuration
+// ======================================
+//   <q> Use the emulated SysTick (SIGALRM) as RTX Kernel Timer
+#ifndef OS_SYSTICK
+ #define OS_SYSTICK     1
+#endif
+//
+//   <o>RTOS Kernel Timer input clock frequency [Hz] <1-1000000000>
+//   <i> Resolution of osKernelSysTick(), the emulated SysTick counts
+//   <i> nanoseconds of CLOCK_MONOTONIC by default.
+#ifndef OS_CLOCK
+ #define OS_CLOCK       1000000000
+#endif
+
+//   <o>RTX Timer tick interval value [us] <1-1000000>
+//   <i> Period of the SIGALRM interval timer.
+//   <i> Default: 1000  (1ms)
+#ifndef OS_TICK
+ #define OS_TICK        1000
+#endif
+
+// </h>
+
+// <h>System Configuration
+// =======================
+//
+// <e>Round-Robin Thread switching
+// ===============================
+//
+// <i> Enables Round-Robin Thread switching.
+#ifndef OS_ROBIN
+ #define OS_ROBIN       1
+#endif
+
+//   <o>Round-Robin Timeout [ticks] <1-1000>
+//   <i> Defines how long a thread will execute before a thread switch.
+//   <i> Default: 5
+#ifndef OS_ROBINTOUT
+ #define OS_ROBINTOUT   5
+#endif
+
+// </e>
+
+// <e>User Timers
+// ==============
+//   <i> Enables user Timers
+#ifndef OS_TIMERS
+ #define OS_TIMERS      1
+#endif
+
+//   <o>Timer Thread Priority
+//                        <1=> Low
+//     <2=> Below Normal  <3=> Normal  <4=> Above Normal
+//                        <5=> High
+//                        <6=> Realtime (highest)
+//   <i> Defines priority for Timer Thread
+//   <i> Default: High
+#ifndef OS_TIMERPRIO
+ #define OS_TIMERPRIO   5
+#endif
+
+//   <o>Timer Thread stack size [bytes] <16384-65528:8><#/4>
+//   <i> Defines stack size for Timer thread.
+//   <i> Default: 16384
+#ifndef OS_TIMERSTKSZ
+ #define OS_TIMERSTKSZ  4096   // this stack size value is in words
+#endif
+
+//   <o>Timer Callback Queue size <1-32>
+//   <i> Number of concurrent active timer callback functions.
+//   <i> Default: 4
+#ifndef OS_TIMERCBQS
+ #define OS_TIMERCBQS   4
+#endif
+
+// </e>
+
+//   <o>ISR FIFO Queue size<4=>   4 entries  <8=>   8 entries
+//                         <12=> 12 entries  <16=> 16 entries
+//                         <24=> 24 entries  <32=> 32 entries
+//                         <48=> 48 entries  <64=> 64 entries
+//                         <96=> 96 entries <128=> 128 entries
+//                         <256=> 256 entries <512=> 512 entries
+//                         <1024=> 1024 entries
+//   <i> ISR functions store requests to this buffer,
+//   <i> when they are called from a signal handler.
+//   <i> With CONFIG_RTX_PSQ_COALESCE a semaphore or thread
+//   <i> takes at most one entry however often it is posted.
+//   <i> Default: 16 entries
+#ifndef OS_FIFOSZ
+ #define OS_FIFOSZ      16
+#endif
+
+// </h>
+
+//------------- <<< end of configuration section >>> -----------------------
+
+/*----------------------------------------------------------------------------
+ *      RTX User configuration part END
+ *---------------------------------------------------------------------------*/
+
+#define OS_TRV          ((uint32_t)(((double)OS_CLOCK*(double)OS_TICK)/1E6)-1)
+
+
+/*----------------------------------------------------------------------------
+ *      Global Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- os_idle_demon ---------------------------------*/
+
+extern void     rt_irq_wait   (void);
+#ifdef CONFIG_RTX_TICKLESS
+extern uint32_t os_tick_sleep (uint32_t ticks);
+#endif
+
+/// \brief The idle demon is running when no other thread is ready to run
+void os_idle_demon (void) {
+#ifdef CONFIG_RTX_TICKLESS
+  uint32_t sleep;
+#endif
+
+  for (;;) {
+    /* HERE: include optional user code to be executed when no thread runs.*/
+#ifdef CONFIG_RTX_STK_WATERMARK
+    /* Move the stack watermark scan on by a few words. */
+    os_stack_scan();
+#endif
+#ifdef CONFIG_RTX_TICKLESS
+    /* Stop the tick until the next timeout is due, then catch up. */
+    sleep = os_suspend();
+    sleep = os_tick_sleep(sleep);
+    os_resume(sleep);
+#else
+    /* Give the host CPU back until the next signal. */
+    rt_irq_wait();
+#endif
+  }
+}
+
+/*--------------------------- os_error --------------------------------------*/
+
+/* OS Error Codes */
+#define OS_ERROR_STACK_OVF      1
+#define OS_ERROR_FIFO_OVF       2
+#define OS_ERROR_MBX_OVF        3
+#define OS_ERROR_TIMER_OVF      4
+
+extern osThreadId svcThreadGetId (void);
+
+/// \brief Called when a runtime error is detected
+/// \param[in]   error_code   actual error code that has been detected
+void os_error (uint32_t error_code) {
+  static const char *const msg[] = {
+    "unknown", "stack overflow", "ISR FIFO overflow",
+    "mailbox overflow", "timer callback queue overflow"
+  };
+
+  if (error_code >= sizeof(msg) / sizeof(msg[0])) {
+    error_code = 0U;
+  }
+  fprintf(stderr, "RTX error: %s (thread %p)\n", msg[error_code],
+          (void *)svcThreadGetId());
+  abort();
+}
+
+
+/*----------------------------------------------------------------------------
+ *      RTX Configuration Functions
+ *---------------------------------------------------------------------------*/
+
+#include "RTX_POSIX_lib.h"
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
@@ -0,0 +1,305 @@
+/*----------------------------------------------------------------------------
+ *      CMSIS-RTOS  -  RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RTX_POSIX_LIB.H
+ *      Purpose: RTX Kernel System Configuration for the POSIX host port
+ *      Rev.:    V4.81
+ *----------------------------------------------------------------------------
+ *
+ * Host counterpart of RTX_CM_lib.h: kernel globals and memory pools sized
+ * from RTX_Conf_POSIX.c, and the start up that turns main() into the main
+ * thread. The program is linked with -Wl,--wrap=main so the C runtime
+ * calls __wrap_main(), which starts the kernel with __real_main() as its
+ * first thread. The process exits with the value main() returns.
+ *---------------------------------------------------------------------------*/
+
+#define __USED __attribute__((used))
+
+
+/*----------------------------------------------------------------------------
+ *      Definitions
+ *---------------------------------------------------------------------------*/
+
+#define _declare_box(pool,size,cnt)  uint32_t pool[(((size)+3)/4)*(cnt) + 3]
+#define _declare_box8(pool,size,cnt) uint64_t pool[(((size)+7)/8)*(cnt) + 2]
+
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+#define OS_TCB_RDYQ     8
+#else
+#define OS_TCB_RDYQ     0
+#endif
+#ifdef CONFIG_RTX_CPU_STAT
+#define OS_TCB_CPU      12
+#else
+#define OS_TCB_CPU      0
+#endif
+#ifdef CONFIG_RTX_STK_WATERMARK
+#define OS_TCB_STK      4
+#else
+#define OS_TCB_STK      0
+#endif
+#ifdef CONFIG_RTX_PSQ_COALESCE
+#define OS_TCB_PSQ      4
+#else
+#define OS_TCB_PSQ      0
+#endif
+#ifdef CONFIG_RTX_PREEMPT_THR
+#define OS_TCB_THR      4
+#else
+#define OS_TCB_THR      0
+#endif
+#ifdef CONFIG_RTX_ROBIN_SLICE
+#define OS_TCB_RBN      4
+#else
+#define OS_TCB_RBN      0
+#endif
+#ifdef CONFIG_RTX_EDF
+#define OS_TCB_EDF      20
+#else
+#define OS_TCB_EDF      0
+#endif
+#ifdef CONFIG_RTX_FAST_SYNC
+#define OS_TCB_FAST     4
+#else
+#define OS_TCB_FAST     0
+#endif
+#define OS_TCB_SIZE     (56+OS_TCB_RDYQ+OS_TCB_CPU+OS_TCB_STK+OS_TCB_PSQ+ \
+                         OS_TCB_THR+OS_TCB_RBN+OS_TCB_EDF+OS_TCB_FAST)
+#define OS_TMR_SIZE     8
+
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+#if (OS_TASKCNT == 0)
+#error "Invalid number of concurrent running threads!"
+#endif
+
+#ifdef CONFIG_RTX_STK_POOLS
+#define OS_STKCLS_CNT (OS_STKCLS0_CNT+OS_STKCLS1_CNT+OS_STKCLS2_CNT+OS_STKCLS3_CNT)
+#else
+#define OS_STKCLS_CNT 0
+#endif
+
+#if ((OS_PRIVCNT+OS_STKCLS_CNT) >= OS_TASKCNT)
+#error "Too many threads with user-provided stack size!"
+#endif
+
+#ifdef CONFIG_RTX_STK_POOLS
+#if ((OS_STKCLS0_SIZE & 7) || (OS_STKCLS1_SIZE & 7) || (OS_STKCLS2_SIZE & 7) || (OS_STKCLS3_SIZE & 7))
+#error "Stack size class block sizes must be multiples of 8 bytes!"
+#endif
+#if ((OS_STKCLS0_SIZE > OS_STKCLS1_SIZE) || (OS_STKCLS1_SIZE > OS_STKCLS2_SIZE) || \
+     (OS_STKCLS2_SIZE > OS_STKCLS3_SIZE) || (OS_STKCLS3_SIZE > 65535))
+#error "Stack size classes must ascend and stay below 64 KB!"
+#endif
+#endif
+
+#if ((OS_STKSIZE*4) > 65535) || ((OS_MAINSTKSIZE*4) > 65535) || ((OS_TIMERSTKSZ*4) > 65535)
+#error "Thread stack sizes are limited to 64 KB!"
+#endif
+
+#if (OS_TIMERS != 0)
+#define OS_TASK_CNT (OS_TASKCNT + 1)
+#define OS_PRIV_CNT (OS_PRIVCNT + 2)
+#define OS_STACK_SZ (4*(OS_PRIVSTKSIZE+OS_MAINSTKSIZE+OS_TIMERSTKSZ))
+#else
+#define OS_TASK_CNT  OS_TASKCNT
+#define OS_PRIV_CNT (OS_PRIVCNT + 1)
+#define OS_STACK_SZ (4*(OS_PRIVSTKSIZE+OS_MAINSTKSIZE))
+#endif
+
+#ifndef OS_STKINIT
+#define OS_STKINIT  0
+#endif
+
+extern uint16_t const os_maxtaskrun;
+extern uint32_t const os_stackinfo;
+extern uint32_t const os_rrobin;
+extern uint32_t const os_trv;
+extern uint8_t  const os_flags;
+
+uint16_t const os_maxtaskrun = OS_TASK_CNT;
+uint32_t const os_stackinfo  = (OS_STKINIT<<28) | (OS_STKCHECK<<24) | (OS_PRIV_CNT<<16) | (OS_STKSIZE*4);
+uint32_t const os_rrobin     = (OS_ROBIN << 16) | OS_ROBINTOUT;
+uint32_t const os_tickfreq   = OS_CLOCK;
+uint16_t const os_tickus_i   = OS_CLOCK/1000000;
+uint16_t const os_tickus_f   = (((uint64_t)(OS_CLOCK-1000000*(OS_CLOCK/1000000)))<<16)/1000000;
+uint32_t const os_trv        = OS_TRV;
+uint8_t  const os_flags      = OS_RUNPRIV;
+
+extern uint32_t const CMSIS_RTOS_API_Version;
+__USED uint32_t const CMSIS_RTOS_API_Version = osCMSIS;
+extern uint32_t const CMSIS_RTOS_RTX_Version;
+__USED uint32_t const CMSIS_RTOS_RTX_Version = osCMSIS_RTX;
+extern uint32_t const os_clockrate;
+__USED uint32_t const os_clockrate = OS_TICK;
+extern uint32_t const os_timernum;
+__USED uint32_t const os_timernum  = 0U;
+
+/* Memory pool for TCB allocation    */
+extern
+uint32_t       mp_tcb[];
+_declare_box  (mp_tcb, OS_TCB_SIZE, OS_TASK_CNT);
+extern
+uint16_t const mp_tcb_size;
+uint16_t const mp_tcb_size = sizeof(mp_tcb);
+
+/* Memory pool for System stack allocation (+os_idle_demon). */
+extern
+uint64_t       mp_stk[];
+_declare_box8 (mp_stk, OS_STKSIZE*4, OS_TASK_CNT-OS_PRIV_CNT-OS_STKCLS_CNT+1);
+extern
+uint32_t const mp_stk_size;
+uint32_t const mp_stk_size = sizeof(mp_stk);
+
+#ifdef CONFIG_RTX_STK_POOLS
+/* Memory pools for user specified stack sizes, one per size class */
+extern
+uint64_t       mp_stkcls0[];
+_declare_box8 (mp_stkcls0, OS_STKCLS0_SIZE, OS_STKCLS0_CNT);
+extern
+uint64_t       mp_stkcls1[];
+_declare_box8 (mp_stkcls1, OS_STKCLS1_SIZE, OS_STKCLS1_CNT);
+extern
+uint64_t       mp_stkcls2[];
+_declare_box8 (mp_stkcls2, OS_STKCLS2_SIZE, OS_STKCLS2_CNT);
+extern
+uint64_t       mp_stkcls3[];
+_declare_box8 (mp_stkcls3, OS_STKCLS3_SIZE, OS_STKCLS3_CNT);
+extern
+void    *const os_stkcls_pool[];
+void    *const os_stkcls_pool[] = { mp_stkcls0, mp_stkcls1, mp_stkcls2, mp_stkcls3 };
+extern
+uint32_t const os_stkcls_psz[];
+uint32_t const os_stkcls_psz[]  = { sizeof(mp_stkcls0), sizeof(mp_stkcls1),
+                                    sizeof(mp_stkcls2), sizeof(mp_stkcls3) };
+extern
+uint32_t const os_stkcls_info[];
+uint32_t const os_stkcls_info[] = { (OS_STKCLS0_CNT<<16) | OS_STKCLS0_SIZE,
+                                    (OS_STKCLS1_CNT<<16) | OS_STKCLS1_SIZE,
+                                    (OS_STKCLS2_CNT<<16) | OS_STKCLS2_SIZE,
+                                    (OS_STKCLS3_CNT<<16) | OS_STKCLS3_SIZE };
+#endif
+
+/* Memory pool for user specified stack allocation (+main, +timer) */
+extern
+uint64_t       os_stack_mem[];
+uint64_t       os_stack_mem[2+OS_PRIV_CNT+(OS_STACK_SZ/8)];
+extern
+uint32_t const os_stack_sz;
+uint32_t const os_stack_sz = sizeof(os_stack_mem);
+
+#ifndef OS_FIFOSZ
+#define OS_FIFOSZ       16
+#endif
+#if (OS_FIFOSZ > 65535)
+#error "ISR FIFO Queue size (OS_FIFOSZ) exceeds 65535 entries"
+#endif
+
+/* Fifo Queue buffer for ISR requests.*/
+extern
+uint32_t       os_fifo[];
+uint32_t       os_fifo[OS_FIFOSZ*2+2];
+extern
+uint16_t const os_fifo_size;
+uint16_t const os_fifo_size = OS_FIFOSZ;
+
+/* An array of Active task pointers. */
+extern
+void *os_active_TCB[];
+void *os_active_TCB[OS_TASK_CNT];
+
+/* User Timers Resources */
+#if (OS_TIMERS != 0)
+extern void osTimerThread (void const *argument);
+extern const osThreadDef_t os_thread_def_osTimerThread;
+osThreadDef(osTimerThread, (osPriority)(OS_TIMERPRIO-3), 1, 4*OS_TIMERSTKSZ);
+extern
+osThreadId osThreadId_osTimerThread;
+osThreadId osThreadId_osTimerThread;
+extern uint32_t os_messageQ_q_osTimerMessageQ[];
+extern const osMessageQDef_t os_messageQ_def_osTimerMessageQ;
+osMessageQDef(osTimerMessageQ, OS_TIMERCBQS, void *);
+extern
+osMessageQId osMessageQId_osTimerMessageQ;
+osMessageQId osMessageQId_osTimerMessageQ;
+#else
+extern
+const osThreadDef_t os_thread_def_osTimerThread;
+const osThreadDef_t os_thread_def_osTimerThread = { NULL, osPriorityNormal, 0U, 0U };
+extern
+osThreadId osThreadId_osTimerThread;
+osThreadId osThreadId_osTimerThread;
+extern uint32_t os_messageQ_q_osTimerMessageQ[];
+extern const osMessageQDef_t os_messageQ_def_osTimerMessageQ;
+osMessageQDef(osTimerMessageQ, 0U, void *);
+extern
+osMessageQId osMessageQId_osTimerMessageQ;
+osMessageQId osMessageQId_osTimerMessageQ;
+#endif
+
+/* Legacy RTX User Timers not used */
+extern
+uint32_t       os_tmr;
+uint32_t       os_tmr = 0U;
+extern
+uint32_t const *m_tmr;
+uint32_t const *m_tmr = NULL;
+extern
+uint16_t const mp_tmr_size;
+uint16_t const mp_tmr_size = 0U;
+
+
+/*----------------------------------------------------------------------------
+ *      RTX Optimizations (empty functions)
+ *---------------------------------------------------------------------------*/
+
+#if OS_ROBIN == 0
+extern
+void rt_init_robin (void);
+void rt_init_robin (void) {;}
+extern
+void rt_chk_robin  (void);
+void rt_chk_robin  (void) {;}
+#endif
+
+#if OS_STKCHECK == 0
+extern
+void rt_stk_check  (void);
+void rt_stk_check  (void) {;}
+#endif
+
+
+/*----------------------------------------------------------------------------
+ *      RTX Startup
+ *---------------------------------------------------------------------------*/
+
+/* Main Thread definition */
+extern int __real_main (void);
+static void os_main_thread (void const *argument);
+extern
+const osThreadDef_t os_thread_def_main;
+const osThreadDef_t os_thread_def_main = {os_main_thread, osPriorityNormal, 1U, 4*OS_MAINSTKSIZE };
+
+static void os_main_thread (void const *argument) {
+  (void)argument;
+  exit(__real_main());
+}
+
+/* Line buffered stdout, so output of preempted threads is not interleaved */
+static char os_stdout_buf[BUFSIZ];
+
+extern int __wrap_main (void);
+int __wrap_main (void) {
+  setvbuf(stdout, os_stdout_buf, _IOLBF, sizeof(os_stdout_buf));
+  osKernelInitialize();
+  osThreadCreate(&os_thread_def_main, NULL);
+  osKernelStart();
+  for (;;);
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
@@ -0,0 +1,7 @@
+#ifndef __BOARD_CONFIG_H
+#define __BOARD_CONFIG_H
+
+/* Host stand-in for the board configuration of the POSIX port */
+#define CONFIG_SYS_HZ		(1000)
+
+#endif /* __BOARD_CONFIG_H */
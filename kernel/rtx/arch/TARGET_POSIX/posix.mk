@@ -0,0 +1,71 @@
+######################################################################
+# Build an application against the POSIX host port of RTX
+#
+#   make -f kernel/rtx/arch/TARGET_POSIX/posix.mk APP=app/benchmark/rtx
+#   make -f kernel/rtx/arch/TARGET_POSIX/posix.mk APP=app/benchmark/rtx run
+#
+# Run from the top of the tree. Kernel options come from .config when
+# there is one and may be given on the command line, for example
+# CONFIG_RTX_DLY_WHEEL=y. The objects of the kernel and the application
+# are taken from obj-y in their kbuild Makefiles.
+#
+# The kernel keeps pointers in 32-bit words, so the program is built
+# with -m32 and needs a 32-bit host libc (gcc-multilib on Debian).
+
+APP	?= app/benchmark/rtx
+O	?= posix
+
+HOSTCC	?= cc
+POSIX_CFLAGS := -m32 -O2 -g -Wall -Wextra -Wno-unused-parameter \
+		-Wno-missing-field-initializers -fno-strict-aliasing
+POSIX_LDFLAGS := -m32 -Wl,--wrap=main
+
+sinclude .config
+
+CONFIG_RTX_DLY_WHEEL_BITS ?= 6
+CONFIG_RTX_TMR_WHEEL_BITS ?= 5
+CONFIG_RTX_CPU_STAT_WINDOW ?= 1000
+CONFIG_RTX_TRACE_BITS ?= 9
+
+rtx-options := $(foreach v,$(filter CONFIG_RTX_%,$(.VARIABLES)),\
+		$(if $(filter y,$($(v))),-D$(v)=1,\
+		$(if $(filter-out n,$($(v))),-D$(v)=$($(v)))))
+
+RTXDIR	:= kernel/rtx
+POSIXDIR := $(RTXDIR)/arch/TARGET_POSIX
+
+CPPFLAGS := -DTARGET_POSIX -D__CMSIS_RTOS -D_GNU_SOURCE $(rtx-options) \
+	    -I$(POSIXDIR) -I$(RTXDIR)/kernel -Iinclude
+
+obj-y	:=
+include $(RTXDIR)/kernel/Makefile
+rtx-src	:= $(addprefix $(RTXDIR)/kernel/,$(obj-y:.o=.c)) \
+	   $(POSIXDIR)/HAL_POSIX.c \
+	   $(POSIXDIR)/RTX_Conf_POSIX.c \
+	   $(RTXDIR)/arch/TARGET_CORTEX_M/rt_CMSIS.c
+
+obj-y	:=
+include $(APP)/Makefile
+app-src	:= $(addprefix $(APP)/,$(obj-y:.o=.c))
+
+objs	:= $(addprefix $(O)/,$(rtx-src:.c=.o) $(app-src:.c=.o))
+target	:= $(O)/$(notdir $(APP))
+
+all: $(target)
+
+$(target): $(objs)
+	$(HOSTCC) $(POSIX_LDFLAGS) -o $@ $^
+
+$(O)/%.o: %.c $(MAKEFILE_LIST)
+	@mkdir -p $(dir $@)
+	$(HOSTCC) $(POSIX_CFLAGS) $(CPPFLAGS) -MMD -MP -c -o $@ $<
+
+-include $(objs:.o=.d)
+
+run: $(target)
+	./$(target)
+
+clean:
+	rm -rf $(O)
+
+.PHONY: all run clean
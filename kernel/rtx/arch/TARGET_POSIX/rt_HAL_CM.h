@@ -0,0 +1,333 @@
+/*----------------------------------------------------------------------------
+ *      CMSIS-RTOS  -  RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_HAL_CM.H
+ *      Purpose: Hardware Abstraction Layer for the POSIX host port
+ *      Rev.:    V4.79
+ *----------------------------------------------------------------------------
+ *
+ * The portable kernel includes "rt_HAL_CM.h" by name, so the host port
+ * provides a header of the same name. Threads run on ucontext contexts,
+ * SysTick is a periodic SIGALRM and PRIMASK, IPSR and the PendSV/SysTick
+ * pending bits are plain variables checked on every return to thread mode.
+ *---------------------------------------------------------------------------*/
+
+/* Definitions */
+#define INITIAL_xPSR    0x01000000U
+#define MAGIC_WORD      0xE25A2EA5U
+#define MAGIC_PATTERN   0xCCCCCCCCU
+
+#undef  __USE_EXCLUSIVE_ACCESS
+
+#define __inline inline
+#define __weak   __attribute__((weak))
+
+/* Emulated exception numbers (IPSR) */
+#define OS_IPSR_SVC     11U
+#define OS_IPSR_PENDSV  14U
+#define OS_IPSR_SYSTICK 15U
+#define OS_IPSR_IRQ     16U
+
+/* Emulated pending exceptions (ICSR PENDSTSET and PENDSVSET >> 26) */
+#define OS_PEND_ST      0x01U
+#define OS_PEND_SV      0x04U
+
+/* Variables */
+extern volatile U32 os_primask;         /* Interrupts disabled               */
+extern volatile U32 os_ipsr;            /* Active exception, 0: thread mode  */
+extern volatile U32 os_control;         /* Thread mode privilege and stack   */
+extern volatile U32 os_pend;            /* Pending PendSV and SysTick        */
+extern volatile U32 os_tick_on;         /* SysTick interrupt enabled         */
+#ifdef CONFIG_RTX_FAST_SYNC
+extern volatile void *volatile os_excl; /* Exclusive monitor address         */
+#endif
+
+/* Functions */
+extern void rt_irq_take   (void);
+extern void rt_irq_pend   (U32 flags);
+extern U32  rt_irq_unpend (U32 flags);
+extern void rt_irq_wait   (void);
+extern void rt_irq_run    (void (*isr)(void));
+
+__attribute__((always_inline)) static inline U32 __get_PRIMASK(void)
+{
+  return os_primask;
+}
+
+__attribute__((always_inline)) static inline void __enable_irq(void)
+{
+  __asm volatile ("" ::: "memory");
+  os_primask = 0U;
+  if ((os_pend != 0U) && (os_ipsr == 0U)) {
+    rt_irq_take ();
+  }
+}
+
+__attribute__((always_inline)) static inline U32 __disable_irq(void)
+{
+  U32 result;
+
+  result = os_primask;
+  os_primask = 1U;
+  __asm volatile ("" ::: "memory");
+  return(result);
+}
+
+__attribute__((always_inline)) static inline void __DMB(void)
+{
+  __asm volatile ("" ::: "memory");
+}
+
+__attribute__((always_inline)) static inline void __DSB(void)
+{
+  __asm volatile ("" ::: "memory");
+}
+
+__attribute__((always_inline)) static inline void __ISB(void)
+{
+  __asm volatile ("" ::: "memory");
+}
+
+__attribute__((always_inline)) static inline U32 __get_IPSR(void)
+{
+  return os_ipsr;
+}
+
+__attribute__((always_inline)) static inline U32 __get_CONTROL(void)
+{
+  return os_control;
+}
+
+__attribute__((always_inline)) static inline void __set_CONTROL(U32 control)
+{
+  os_control = control;
+}
+
+#define __set_PSP(stack) rt_set_PSP (stack)
+
+#define OS_PEND_IRQ()   rt_irq_pend (OS_PEND_SV)
+#define OS_PENDING      (os_pend & (OS_PEND_ST | OS_PEND_SV))
+#define OS_UNPEND(fl)   fl = (U8)rt_irq_unpend (OS_PEND_ST | OS_PEND_SV)
+#define OS_PEND(fl,p)   rt_irq_pend ((U32)(fl | (U8)(p<<2)))
+#define OS_LOCK()       os_tick_on = 0U
+#define OS_UNLOCK()     os_tick_on = 1U
+
+/* The kernel tick is always the emulated SysTick (os_tick_irqn < 0) */
+#define OS_X_PENDING    0U
+#define OS_X_UNPEND(fl) fl = 0U
+#define OS_X_PEND(fl,p) OS_PEND(fl,p)
+#define OS_X_INIT(n)
+#define OS_X_LOCK(n)    OS_LOCK()
+#define OS_X_UNLOCK(n)  OS_UNLOCK()
+
+/* Functions */
+
+/* Kernel critical sections; CONFIG_RTX_BASEPRI has no effect on the host, */
+/* there are no interrupts above the kernel to leave running.              */
+__inline static U32 rt_irq_lock (void) {
+  U32 primask = __get_PRIMASK();
+  __disable_irq();
+  return (primask);
+}
+
+__inline static void rt_irq_unlock (U32 primask) {
+  if (!primask) {
+    __enable_irq ();
+  }
+}
+
+#define rt_inc(p) do {\
+                    U32 lock = rt_irq_lock();\
+                    (*p)++;\
+                    rt_irq_unlock(lock);\
+                  } while (0)
+#define rt_dec(p) do {\
+                    U32 lock = rt_irq_lock();\
+                    (*p)--;\
+                    rt_irq_unlock(lock);\
+                  } while (0)
+
+__inline static U32 rt_inc_qi (U32 size, U16 *count, U16 *first) {
+  U32 cnt,c2;
+  U32 lock = rt_irq_lock();
+  if ((cnt = *count) < size) {
+    *count = (U16)(cnt+1U);
+    c2 = (cnt = *first) + 1U;
+    if (c2 == size) { c2 = 0U; }
+    *first = (U16)c2;
+  }
+  rt_irq_unlock (lock);
+  return (cnt);
+}
+
+__inline static U32 rt_add_qi (U32 size, U16 *count, U16 *first, U32 n) {
+  /* Take "n" entries at once, return the index of the first one or "size" */
+  /* when they do not fit.                                                  */
+  U32 cnt,idx,c2;
+  U32 lock = rt_irq_lock();
+  if (((cnt = *count) + n) > size) {
+    idx = size;
+  }
+  else {
+    *count = (U16)(cnt+n);
+    c2 = (idx = *first) + n;
+    if (c2 >= size) { c2 -= size; }
+    *first = (U16)c2;
+  }
+  rt_irq_unlock (lock);
+  return (idx);
+}
+
+__inline static U32 rt_fetch_inc (U32 *p) {
+  /* Increment "*p" atomically, return its value before. */
+  U32 val;
+  U32 lock = rt_irq_lock();
+  val = (*p)++;
+  rt_irq_unlock (lock);
+  return (val);
+}
+
+#ifdef CONFIG_RTX_PSQ_COALESCE
+__inline static U32 rt_fetch_or16 (U16 *p, U32 val) {
+  /* Set bits "val" in "*p" atomically, return its value before. */
+  U32 old;
+  U32 lock = rt_irq_lock();
+  old = *p;
+  *p  = (U16)(old|val);
+  rt_irq_unlock (lock);
+  return (old);
+}
+
+__inline static U32 rt_fetch_inc16 (U16 *p) {
+  /* Increment "*p" atomically, return its value before. */
+  U32 old;
+  U32 lock = rt_irq_lock();
+  old = *p;
+  *p  = (U16)(old+1U);
+  rt_irq_unlock (lock);
+  return (old);
+}
+
+__inline static U32 rt_swap16 (U16 *p, U32 val) {
+  /* Write "val" to "*p" atomically, return its value before. */
+  U32 old;
+  U32 lock = rt_irq_lock();
+  old = *p;
+  *p  = (U16)val;
+  rt_irq_unlock (lock);
+  return (old);
+}
+#endif
+
+#ifdef CONFIG_RTX_FAST_SYNC
+/* Exclusive access: the monitor holds the address of the last exclusive */
+/* load and is cleared by every emulated exception.                       */
+__inline static U32 rt_ldrex_w (volatile U32 *p) {
+  os_excl = p;
+  __asm volatile ("" ::: "memory");
+  return (*p);
+}
+
+__inline static U32 rt_strex_w (U32 val, volatile U32 *p) {
+  U32 lock = rt_irq_lock();
+  U32 fail = (os_excl != p);
+  if (!fail) {
+    *p = val;
+  }
+  os_excl = NULL;
+  rt_irq_unlock (lock);
+  return (fail);
+}
+
+__inline static U32 rt_ldrex_h (volatile U16 *p) {
+  os_excl = p;
+  __asm volatile ("" ::: "memory");
+  return (*p);
+}
+
+__inline static U32 rt_strex_h (U32 val, volatile U16 *p) {
+  U32 lock = rt_irq_lock();
+  U32 fail = (os_excl != p);
+  if (!fail) {
+    *p = (U16)val;
+  }
+  os_excl = NULL;
+  rt_irq_unlock (lock);
+  return (fail);
+}
+
+__inline static void *rt_ldrex_ptr (void *volatile *p) {
+  os_excl = p;
+  __asm volatile ("" ::: "memory");
+  return (*p);
+}
+
+__inline static U32 rt_strex_ptr (void *val, void *volatile *p) {
+  U32 lock = rt_irq_lock();
+  U32 fail = (os_excl != p);
+  if (!fail) {
+    *p = val;
+  }
+  os_excl = NULL;
+  rt_irq_unlock (lock);
+  return (fail);
+}
+
+#define rt_ldrex_p(p)   rt_ldrex_ptr ((void *volatile *)(p))
+#define rt_strex_p(v,p) rt_strex_ptr ((void *)(v), (void *volatile *)(p))
+
+__inline static void rt_clrex (void) {
+  os_excl = NULL;
+}
+#endif
+
+extern void rt_systick_init  (void);
+extern U32  rt_systick_val   (void);
+extern U32  rt_systick_ovf   (void);
+extern U32  rt_systick_sleep (U32 ticks);
+extern U32  rt_cpu_cycles    (void);
+
+__inline static void rt_cpu_start (void) {
+  /* The monotonic clock always runs. */
+}
+
+__inline static U32 *rt_msp_area (U32 *words) {
+  /* Interrupts run on the stack of the thread they preempt. */
+  *words = 0U;
+  return (NULL);
+}
+
+__inline static void rt_msp_fill (void) {
+  /* No main stack to fill. */
+}
+
+__inline static U32 rt_msb (U32 value) {
+  /* Return index of the most significant bit set in non-zero "value". */
+  return (31U - (U32)__builtin_clz(value));
+}
+
+#define rt_wfi()        rt_irq_wait()
+
+__inline static void rt_svc_init (void) {
+  /* SVC and PendSV need no set up, they are emulated in place. */
+}
+
+extern void rt_set_PSP (U32 stack);
+extern U32  rt_get_PSP (void);
+extern void *_alloc_box (void *box_mem);
+extern U32  _free_box (void *box_mem, void *box);
+
+extern void rt_init_stack (P_TCB p_TCB, FUNCP task_body);
+extern void rt_ret_val  (P_TCB p_TCB, U32 v0);
+extern void rt_ret_val2 (P_TCB p_TCB, U32 v0, U32 v1);
+
+extern U32 *rt_svc_enter (void);
+extern void rt_svc_exit  (void);
+
+#define DBG_INIT()
+#define DBG_TASK_NOTIFY(p_tcb,create)
+#define DBG_TASK_SWITCH(task_id)
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
@@ -59,12 +59,18 @@ extern U8  const os_flags;
 extern U32 const os_stackinfo;
 extern U32 const os_rrobin;
 extern U32 const os_clockrate;
+extern U32 const os_tickfreq;
 extern U32 const os_timernum;
 extern U16 const mp_tcb_size;
 extern U32 const mp_stk_size;
 extern U32 const *m_tmr;
 extern U16 const mp_tmr_size;
-extern U8  const os_fifo_size;
+extern U16 const os_fifo_size;
+#ifdef CONFIG_RTX_STK_POOLS
+extern void *const os_stkcls_pool[];
+extern U32 const os_stkcls_psz[];
+extern U32 const os_stkcls_info[];
+#endif
 
 /* Functions */
 extern void os_idle_demon   (void);
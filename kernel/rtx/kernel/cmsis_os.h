@@ -268,6 +268,20 @@ uint32_t osKernelSysTick (void);
 */
 #define osKernelSysTickMicroSec(microsec) ((microsec * os_tickus_i) + ((microsec * os_tickus_f) >> 16))
 
+#ifdef CONFIG_RTX_CLOCK64
+
+/// Get the 64-bit RTOS kernel clock, monotonic and without wrap.
+/// \note Lock-free, may be called from threads and Interrupt Service Routines.
+/// \return clock in \ref osKernelSysTickFrequency units since \ref osKernelInitialize.
+uint64_t osKernelSysTick64 (void);
+
+/// Get the 64-bit RTOS kernel clock in nanoseconds.
+/// \note Lock-free, may be called from threads and Interrupt Service Routines.
+/// \return nanoseconds since \ref osKernelInitialize.
+uint64_t osKernelNanoSec (void);
+
+#endif
+
 #endif    // System Timer available
 
 //  ==== Thread Management ====
@@ -299,6 +313,19 @@ const osThreadDef_t os_thread_def_##name = \
 /// \return thread ID for reference by other functions or NULL in case of error.
 osThreadId osThreadCreate (const osThreadDef_t *thread_def, void *argument);
 
+#ifdef CONFIG_RTX_PREEMPT_THR
+/// Create a thread with a preemption threshold: while it runs only threads
+/// with a priority above \a threshold preempt it. Threads given the same
+/// threshold do not preempt each other. The running thread reports its
+/// threshold in \ref osThreadGetPriority.
+/// \param[in]     thread_def    thread definition referenced with \ref osThread.
+/// \param[in]     argument      pointer that is passed to the thread function as start argument.
+/// \param[in]     threshold     preemption threshold, from the thread priority to \ref osPriorityRealtime.
+/// \return thread ID for reference by other functions or NULL in case of error.
+osThreadId osThreadCreateEx (const osThreadDef_t *thread_def, void *argument,
+                             osPriority threshold);
+#endif
+
 /// Return the thread ID of the current running thread.
 /// \return thread ID for reference by other functions or NULL in case of error.
 osThreadId osThreadGetId (void);
@@ -323,6 +350,21 @@ osStatus osThreadSetPriority (osThreadId thread_id, osPriority priority);
 /// \return current priority value of the thread function.
 osPriority osThreadGetPriority (osThreadId thread_id);
 
+#ifdef CONFIG_RTX_ROBIN_SLICE
+/// Set the round robin time slice of an active thread.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadCreate or \ref osThreadGetId.
+/// \param[in]     millisec      time slice in millisec, 0 for the default of OS_ROBINTOUT.
+/// \return status code that indicates the execution status of the function.
+osStatus osThreadSetSlice (osThreadId thread_id, uint32_t millisec);
+
+/// Turn round robin on or off for the threads of one priority. With it off
+/// a thread keeps the CPU until it blocks or yields, whatever its slice.
+/// \param[in]     priority      priority level.
+/// \param[in]     enable        0 to turn round robin off, else on (default).
+/// \return status code that indicates the execution status of the function.
+osStatus osRoundRobinSet (osPriority priority, uint32_t enable);
+#endif
+
 
 //  ==== Generic Wait Functions ====
 
@@ -340,17 +382,96 @@ os_InRegs osEvent osWait (uint32_t millisec);
 
 #endif  // Generic Wait available
 
+#ifdef CONFIG_RTX_WAIT_ANY
+
+/// Object of a Mail Queue for \ref osWaitAny: its queue of mail pointers.
+/// \param         queue_id      mail queue ID obtained with \ref osMailCreate.
+#define osWaitMail(queue_id) \
+(*(void * const *)(queue_id))
+
+/// Wait for any of several Semaphores, Message Queues and Mail Queues, or Signals.
+/// \param[in]     objects       semaphore and message queue IDs, and mail queues given with \ref osWaitMail.
+/// \param[in]     count         number of objects, up to 8.
+/// \param[in]     signals       signal flags that end the wait as well, 0 for none.
+/// \param[out]    value         message, mail, 1 for a semaphore token (0 if it was deleted) or the signal flags; may be NULL.
+/// \param[in]     millisec      \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return index of the object taken from, \a count for signals, -1 on time-out, -2 on a parameter error.
+int32_t osWaitAny (void * const *objects, uint32_t count, int32_t signals, uint32_t *value, uint32_t millisec);
+
+#endif
+
+#ifdef CONFIG_RTX_EDF
+
+//  ==== Earliest Deadline First Scheduling ====
+
+/// Schedule the running thread by the deadline of its jobs: move it to the
+/// EDF priority band and release its first job now.
+/// \param[in]     period        time between job releases in millisec, 0 to stop.
+/// \param[in]     deadline      time from release to deadline in millisec, up to \a period; 0 for \a period.
+/// \return status code that indicates the execution status of the function.
+osStatus osEdfStart (uint32_t period, uint32_t deadline);
+
+/// End the job of the running thread and wait for the release of the next
+/// one, at the following multiple of the period.
+/// \return status code that indicates the execution status of the function.
+osStatus osEdfWait (void);
+
+/// Get the number of jobs of a thread that ended after their deadline.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadCreate or \ref osThreadGetId.
+/// \return number of missed deadlines.
+uint32_t osEdfMisses (osThreadId thread_id);
+
+#endif
+
+#ifdef CONFIG_RTX_PERIODIC
+
+//  ==== Periodic Threads ====
+
+/// Periodic thread control block, owned by the thread that runs the loop.
+/// The statistics may be read by any thread; times are in \ref osKernelSysTick counts.
+typedef struct os_period  {
+  uint32_t                  period;    ///< time between releases in kernel ticks
+  uint32_t                 release;    ///< kernel tick of the current release
+  uint32_t                   start;    ///< system timer when the current job started
+  uint32_t                    jobs;    ///< number of jobs ended
+  uint32_t                overruns;    ///< number of releases skipped by jobs that ran into them
+  uint32_t              jitter_max;    ///< largest delay from a release to the start of its job
+  uint64_t              jitter_sum;    ///< sum of the delays from release to start
+  uint32_t                exec_max;    ///< longest job, from its start to \ref osPeriodWait
+  uint64_t                exec_sum;    ///< sum of the job times
+} osPeriod;
+
+/// Start a periodic loop in the running thread: its first job is released now.
+/// \param[out]    period        periodic thread control block of the running thread.
+/// \param[in]     millisec      time between job releases in millisec.
+/// \return status code that indicates the execution status of the function.
+osStatus osPeriodStart (osPeriod *period, uint32_t millisec);
+
+/// End the job of the running thread and wait for the release of the next
+/// one, at the following multiple of the period from the first release.
+/// Releases passed while the job ran are skipped and counted as overruns.
+/// \param[in,out] period        periodic thread control block of the running thread.
+/// \return status code that indicates the execution status of the function.
+osStatus osPeriodWait (osPeriod *period);
+
+#endif
+
 
 //  ==== Timer Management Functions ====
 /// Define a Timer object.
 /// \param         name          name of the timer object.
 /// \param         function      name of the timer call back function.
+#ifdef CONFIG_RTX_TMR_WHEEL
+#define os_timer_cb_words 7      // timer control block with wheel back link
+#else
+#define os_timer_cb_words 6
+#endif
 #if defined (osObjectsExternal)  // object is external
 #define osTimerDef(name, function)  \
 extern const osTimerDef_t os_timer_def_##name
 #else                            // define the object
 #define osTimerDef(name, function)  \
-uint32_t os_timer_cb_##name[6]; \
+uint32_t os_timer_cb_##name[os_timer_cb_words]; \
 const osTimerDef_t os_timer_def_##name = \
 { (function), (os_timer_cb_##name) }
 #endif
@@ -456,12 +577,17 @@ osStatus osMutexDelete (osMutexId mutex_id);
 
 /// Define a Semaphore object.
 /// \param         name          name of the semaphore object.
+#ifdef CONFIG_RTX_PSQ_COALESCE
+#define os_semaphore_cb_words 3  // semaphore control block with ISR token count
+#else
+#define os_semaphore_cb_words 2
+#endif
 #if defined (osObjectsExternal)  // object is external
 #define osSemaphoreDef(name)  \
 extern const osSemaphoreDef_t os_semaphore_def_##name
 #else                            // define the object
 #define osSemaphoreDef(name)  \
-uint32_t os_semaphore_cb_##name[2] = { 0 }; \
+uint32_t os_semaphore_cb_##name[os_semaphore_cb_words] = { 0 }; \
 const osSemaphoreDef_t os_semaphore_def_##name = { (os_semaphore_cb_##name) }
 #endif
 
@@ -495,6 +621,78 @@ osStatus osSemaphoreDelete (osSemaphoreId semaphore_id);
 #endif     // Semaphore available
 
 
+#ifdef CONFIG_RTX_EVT_GROUP
+
+//  ==== Event Group Management Functions ====
+
+/// Event Group ID identifies the event group (pointer to an event group control block).
+typedef struct os_egroup_cb *osEventGroupId;
+
+/// Definition structure for event group.
+typedef struct os_egroup_def  {
+  void                     *egroup;    ///< pointer to internal data
+} osEventGroupDef_t;
+
+/// Wait options of \ref osEventGroupWait.
+#define osEventGroupAny        0x0000U ///< wait for any of the flags
+#define osEventGroupAll        0x0001U ///< wait for all of the flags
+#define osEventGroupNoClear    0x0002U ///< leave the flags set when the wait ends
+
+/// Define an Event Group object.
+/// \param         name          name of the event group object.
+#define os_egroup_cb_words 3
+#if defined (osObjectsExternal)  // object is external
+#define osEventGroupDef(name)  \
+extern const osEventGroupDef_t os_egroup_def_##name
+#else                            // define the object
+#define osEventGroupDef(name)  \
+uint32_t os_egroup_cb_##name[os_egroup_cb_words] = { 0 }; \
+const osEventGroupDef_t os_egroup_def_##name = { (os_egroup_cb_##name) }
+#endif
+
+/// Access an Event Group definition.
+/// \param         name          name of the event group object.
+#define osEventGroup(name)  \
+&os_egroup_def_##name
+
+/// Create and Initialize an Event Group object with all flags cleared.
+/// \param[in]     egroup_def    event group definition referenced with \ref osEventGroup.
+/// \return event group ID for reference by other functions or NULL in case of error.
+osEventGroupId osEventGroupCreate (const osEventGroupDef_t *egroup_def);
+
+/// Set flags of an Event Group and wake all threads whose wait is met.
+/// \param[in]     egroup_id     event group ID obtained by \ref osEventGroupCreate.
+/// \param[in]     flags         flags to set.
+/// \return status code that indicates the execution status of the function.
+osStatus osEventGroupSet (osEventGroupId egroup_id, uint32_t flags);
+
+/// Clear flags of an Event Group, not from an ISR.
+/// \param[in]     egroup_id     event group ID obtained by \ref osEventGroupCreate.
+/// \param[in]     flags         flags to clear.
+/// \return flags before clearing, or 0 in case of an error.
+uint32_t osEventGroupClear (osEventGroupId egroup_id, uint32_t flags);
+
+/// Get the flags of an Event Group.
+/// \param[in]     egroup_id     event group ID obtained by \ref osEventGroupCreate.
+/// \return current flags, or 0 in case of an error.
+uint32_t osEventGroupGet (osEventGroupId egroup_id);
+
+/// Wait for any or all of some flags of an Event Group.
+/// \param[in]     egroup_id     event group ID obtained by \ref osEventGroupCreate.
+/// \param[in]     flags         flags to wait for, not 0.
+/// \param[in]     options       \ref osEventGroupAny or \ref osEventGroupAll, optionally with \ref osEventGroupNoClear.
+/// \param[in]     millisec      \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return flags of the group that met the wait, before the waited ones were cleared, or 0 on time-out or error.
+uint32_t osEventGroupWait (osEventGroupId egroup_id, uint32_t flags, uint32_t options, uint32_t millisec);
+
+/// Delete an Event Group, waiting threads return 0.
+/// \param[in]     egroup_id     event group ID obtained by \ref osEventGroupCreate.
+/// \return status code that indicates the execution status of the function.
+osStatus osEventGroupDelete (osEventGroupId egroup_id);
+
+#endif
+
+
 //  ==== Memory Pool Management Functions ====
 
 #if (defined (osFeature_Pool)  &&  (osFeature_Pool != 0))  // Memory Pool Management available
@@ -589,6 +787,22 @@ osEvent __osMessageGet (osMessageQId queue_id, uint32_t millisec);
 os_InRegs osEvent osMessageGet (osMessageQId queue_id, uint32_t millisec);
 #endif
 
+/// Put up to count Messages to a Queue in one call.
+/// \param[in]     queue_id      message queue ID obtained with \ref osMessageCreate.
+/// \param[in]     info          array of count messages, sent in order.
+/// \param[in]     count         number of messages in info.
+/// \param[in]     millisec      \ref CMSIS_RTOS_TimeOutValue to wait for space when the queue is full, must be 0 in an ISR.
+/// \return number of messages put, or -1 in case of a parameter error.
+int32_t osMessagePutN (osMessageQId queue_id, const uint32_t *info, uint32_t count, uint32_t millisec);
+
+/// Get up to count Messages from a Queue in one call.
+/// \param[in]     queue_id      message queue ID obtained with \ref osMessageCreate.
+/// \param[out]    info          array for up to count messages, filled in order.
+/// \param[in]     count         size of info.
+/// \param[in]     millisec      \ref CMSIS_RTOS_TimeOutValue to wait for a message when the queue is empty, must be 0 in an ISR.
+/// \return number of messages got, or -1 in case of a parameter error.
+int32_t osMessageGetN (osMessageQId queue_id, uint32_t *info, uint32_t count, uint32_t millisec);
+
 #endif     // Message Queues available
 
 
@@ -652,6 +866,21 @@ osEvent __osMailGet (osMailQId queue_id, uint32_t millisec);
 os_InRegs osEvent osMailGet (osMailQId queue_id, uint32_t millisec);
 #endif
 
+/// Put up to count mails to a queue in one call.
+/// \param[in]     queue_id      mail queue ID obtained with \ref osMailCreate.
+/// \param[in]     mail          array of count memory blocks previously allocated with \ref osMailAlloc or \ref osMailCAlloc.
+/// \param[in]     count         number of mails in mail.
+/// \return number of mails put, or -1 in case of a parameter error.
+int32_t osMailPutN (osMailQId queue_id, void *const *mail, uint32_t count);
+
+/// Get up to count mails from a queue in one call.
+/// \param[in]     queue_id      mail queue ID obtained with \ref osMailCreate.
+/// \param[out]    mail          array for up to count memory blocks, filled in order.
+/// \param[in]     count         size of mail.
+/// \param[in]     millisec      \ref CMSIS_RTOS_TimeOutValue to wait for a mail when the queue is empty, must be 0 in an ISR.
+/// \return number of mails got, or -1 in case of a parameter error.
+int32_t osMailGetN (osMailQId queue_id, void **mail, uint32_t count, uint32_t millisec);
+
 /// Free a memory block from a mail.
 /// \param[in]     queue_id      mail queue ID obtained with \ref osMailCreate.
 /// \param[in]     mail          pointer to the memory block that was obtained with \ref osMailGet.
@@ -661,6 +890,85 @@ osStatus osMailFree (osMailQId queue_id, void *mail);
 #endif  // Mail Queues available
 
 
+#ifdef CONFIG_RTX_MSGBUF
+
+//  ==== Message Buffer Management Functions ====
+
+/// Message Buffer ID identifies the message buffer (pointer to a message buffer control block).
+typedef struct os_msgbuf_cb *osMsgBufId;
+
+/// Definition structure for message buffer.
+typedef struct os_msgbuf_def  {
+  uint32_t                    size;    ///< size of the data area in bytes
+  void                     *msgbuf;    ///< pointer to internal data
+} osMsgBufDef_t;
+
+/// \brief Define a Message Buffer.
+/// \param         name          name of the message buffer.
+/// \param         size          size of the data area in bytes; a record takes its
+///                              size rounded up to 4 plus 4 bytes, 4 bytes stay unused.
+#define os_msgbuf_cb_words 13
+#if defined (osObjectsExternal)  // object is external
+#define osMsgBufDef(name, size) \
+extern const osMsgBufDef_t os_msgbuf_def_##name
+#else                            // define the object
+#define osMsgBufDef(name, size) \
+uint32_t os_msgbuf_cb_##name[os_msgbuf_cb_words+((size)+3)/4] = { 0 }; \
+const osMsgBufDef_t os_msgbuf_def_##name = \
+{ ((size)+3)/4*4, (os_msgbuf_cb_##name) }
+#endif
+
+/// \brief Access a Message Buffer definition.
+/// \param         name          name of the message buffer.
+#define osMsgBuf(name) \
+&os_msgbuf_def_##name
+
+/// Create and Initialize a Message Buffer, for one writer (a thread or an ISR) and one reader thread.
+/// \param[in]     msgbuf_def    message buffer definition referenced with \ref osMsgBuf.
+/// \return message buffer ID for reference by other functions or NULL in case of error.
+osMsgBufId osMsgBufCreate (const osMsgBufDef_t *msgbuf_def);
+
+/// Reserve contiguous room for the next record, to be filled in place (writer).
+/// \param[in]     msgbuf_id     message buffer ID obtained by \ref osMsgBufCreate.
+/// \param[in]     size          largest size of the record in bytes.
+/// \return word aligned pointer to the record data or NULL when the buffer has no room.
+void *osMsgBufReserve (osMsgBufId msgbuf_id, uint32_t size);
+
+/// Pass the reserved record to the reader and wake it up when it waits for it (writer).
+/// \param[in]     msgbuf_id     message buffer ID obtained by \ref osMsgBufCreate.
+/// \param[in]     size          size of the record in bytes, up to the size reserved.
+/// \return status code that indicates the execution status of the function.
+osStatus osMsgBufCommit (osMsgBufId msgbuf_id, uint32_t size);
+
+/// Get the oldest record in place, or wait for one (reader).
+/// \param[in]     msgbuf_id     message buffer ID obtained by \ref osMsgBufCreate.
+/// \param[out]    size          size of the record in bytes.
+/// \param[in]     millisec      \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return pointer to the record data or NULL when there is none.
+void *osMsgBufPeek (osMsgBufId msgbuf_id, uint32_t *size, uint32_t millisec);
+
+/// Give the room of the oldest record back to the writer (reader).
+/// \param[in]     msgbuf_id     message buffer ID obtained by \ref osMsgBufCreate.
+/// \return status code that indicates the execution status of the function.
+osStatus osMsgBufRelease (osMsgBufId msgbuf_id);
+
+/// Wait until a Message Buffer holds a number of bytes or of records (reader).
+/// \param[in]     msgbuf_id     message buffer ID obtained by \ref osMsgBufCreate.
+/// \param[in]     bytes         bytes of record data to wait for, 0 to wait for records only.
+/// \param[in]     records       records to wait for, 0 to wait for bytes only.
+/// \param[in]     millisec      \ref CMSIS_RTOS_TimeOutValue or 0 in case of no time-out.
+/// \return status code that indicates the execution status of the function.
+osStatus osMsgBufWait (osMsgBufId msgbuf_id, uint32_t bytes, uint32_t records, uint32_t millisec);
+
+/// Get the amount of data to be read from a Message Buffer.
+/// \param[in]     msgbuf_id     message buffer ID obtained by \ref osMsgBufCreate.
+/// \param[out]    records       records to be read, may be NULL.
+/// \return bytes of record data to be read.
+uint32_t osMsgBufCount (osMsgBufId msgbuf_id, uint32_t *records);
+
+#endif
+
+
 //  ==== RTX Extensions ====
 
 /// Suspend the RTX task scheduler.
@@ -671,6 +979,97 @@ uint32_t os_suspend (void);
 /// \param[in]     sleep_time    specifies how long the system was in sleep or power-down mode.
 void os_resume (uint32_t sleep_time);
 
+/// Get the time spent in sleep or power-down mode and awake since start.
+/// \param[out]    asleep        ticks spent in sleep, may be NULL.
+/// \param[out]    awake         ticks spent awake, may be NULL.
+/// \return number of times the system went to sleep.
+uint32_t os_sleep_stat (uint32_t *asleep, uint32_t *awake);
+
+/// Get the statistics of the queue that passes ISR calls to the kernel.
+/// \param[out]    peak          highest number of queued entries, may be NULL.
+/// \param[out]    merged        posts merged into an entry already queued, may be NULL.
+/// \param[out]    lost          posts lost because the queue was full, may be NULL.
+/// \return number of posts from ISRs since start, wraps around.
+uint32_t os_psq_stat (uint32_t *peak, uint32_t *merged, uint32_t *lost);
+
+#ifdef CONFIG_RTX_CPU_STAT
+
+/// Get the CPU cycles used by a thread since it was created.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadCreate or \ref osThreadGetId.
+/// \return cycles run, wraps around like the cycle counter; 0 for an invalid thread.
+uint32_t os_cpu_cycles (osThreadId thread_id);
+
+/// Get the CPU load of a thread in the last load window.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadCreate or \ref osThreadGetId.
+/// \return load in 0.01 % (10000 is the whole window).
+uint32_t os_cpu_load (osThreadId thread_id);
+
+/// Get the idle and interrupt load in the last load window.
+/// \param[out]    idle          idle thread load in 0.01 %, may be NULL.
+/// \param[out]    irq           interrupt load in 0.01 %, may be NULL.
+/// \return length of the window in cycles, 0 before the first window closed.
+uint32_t os_cpu_stat (uint32_t *idle, uint32_t *irq);
+
+#endif
+
+#if defined(CONFIG_RTX_CPU_STAT) || defined(CONFIG_RTX_TRACE)
+
+/// Count the following time of an interrupt handler as interrupt time and
+/// trace its entry. Call first thing in the handler, paired with \ref os_irq_exit.
+void os_irq_enter (void);
+
+/// End counting interrupt time started by \ref os_irq_enter, trace the exit.
+void os_irq_exit (void);
+
+#endif
+
+#ifdef CONFIG_RTX_TRACE
+
+/// Fill the 16 byte header that starts a trace dump.
+/// \param[out]    buf           header: magic "RTXT", version and record size,
+///                              time stamp clock in Hz, records in the ring.
+/// \return size of the header in bytes.
+uint32_t os_trace_header (uint32_t *buf);
+
+/// Move the oldest recorded kernel events to a buffer, for one reader at a time.
+/// \param[out]    buf           8 byte records: time stamp, lap:3 event:5 task:8 arg:16.
+/// \param[in]     size          size of \a buf in bytes.
+/// \return bytes of records moved, 0 when the trace buffer is empty.
+uint32_t os_trace_read (uint32_t *buf, uint32_t size);
+
+#endif
+
+#ifdef CONFIG_RTX_STK_WATERMARK
+
+/// Move the stack watermark scan on by one step (called by the idle thread).
+/// \return 1 when the step completed a pass over all stacks, 0 otherwise.
+uint32_t os_stack_scan (void);
+
+/// Get the deepest stack use of a thread, or of the main stack, at the last scan.
+/// \param[in]     thread_id     thread ID obtained by \ref osThreadCreate or \ref osThreadGetId, NULL for the main stack.
+/// \param[out]    size          stack size in bytes, may be NULL.
+/// \return bytes of stack used; 0 for an invalid thread or one not scanned yet.
+uint32_t os_stack_used (osThreadId thread_id, uint32_t *size);
+
+/// Scan all stacks and call \a report for each thread, the idle thread and the main stack.
+/// \param[in]     report        callback, thread_id is NULL for the main stack.
+void os_stack_report (void (*report)(osThreadId thread_id, uint32_t size, uint32_t used));
+
+#endif
+
+#ifdef CONFIG_RTX_STK_POOLS
+
+/// Get the use of a stack size class pool.
+/// \param[in]     cls           class number, 0 to 3.
+/// \param[out]    blocks        blocks in the pool, may be NULL.
+/// \param[out]    used          blocks in use, may be NULL.
+/// \param[out]    peak          highest number of blocks in use, may be NULL.
+/// \param[out]    miss          threads that fit the class but found it used up, may be NULL.
+/// \return block size in bytes; 0 for an invalid class.
+uint32_t os_stack_class_stat (uint32_t cls, uint32_t *blocks, uint32_t *used, uint32_t *peak, uint32_t *miss);
+
+#endif
+
 /// OS idle demon (running when no other thread is ready to run).
 __NO_RETURN void os_idle_demon (void);
 
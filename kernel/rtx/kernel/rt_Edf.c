@@ -0,0 +1,117 @@
+/*----------------------------------------------------------------------------
+ *      CMSIS-RTOS  -  RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_EDF.C
+ *      Purpose: Earliest deadline first scheduling
+ *      Rev.:    V4.79
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2015 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_List.h"
+#include "rt_Task.h"
+#include "rt_Time.h"
+#include "rt_Edf.h"
+
+/*----------------------------------------------------------------------------
+ *      Tasks of priority CONFIG_RTX_EDF_PRIO with a period are ordered by
+ *      the absolute deadline of their current job, in the ready list and
+ *      in object wait lists: rt_put_prio() puts them before tasks of the
+ *      band with a later deadline, rt_put_rdy_first() keeps a preempted
+ *      one ahead of the same or later deadlines, and rt_dispatch() lets a
+ *      woken task with an earlier deadline preempt. Jobs are released at
+ *      multiples of the period from the first one, a job that ends after
+ *      its deadline is counted as a miss.
+ *---------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------
+ *      Functions
+ *---------------------------------------------------------------------------*/
+
+
+/*--------------------------- rt_edf_resched --------------------------------*/
+
+static void rt_edf_resched (void) {
+  /* Let a ready task of the band with an earlier deadline preempt. */
+  P_TCB p_first = rt_rdy_first ();
+
+  if ((os_tsk.run->state == RUNNING) && (p_first != NULL) &&
+      (p_first->prio == os_tsk.run->prio) && rt_edf_before (p_first, os_tsk.run)) {
+    rt_put_rdy_first (os_tsk.run);
+    os_tsk.run->state = READY;
+    rt_dispatch (NULL);
+  }
+}
+
+
+/*--------------------------- rt_edf_set ------------------------------------*/
+
+void rt_edf_set (U32 period, U32 deadline) {
+  /* Make the running task periodic with "period" and a relative "deadline" */
+  /* in ticks, its first job is released now. A period of 0 ends it.       */
+  P_TCB p_task = os_tsk.run;
+
+  p_task->edf_period = period;
+  p_task->edf_dline  = deadline;
+  p_task->edf_rel    = os_time;
+  p_task->edf_dl     = os_time + deadline;
+  p_task->edf_miss   = 0U;
+  if (period != 0U) {
+    rt_tsk_prio (0U, CONFIG_RTX_EDF_PRIO);
+    rt_edf_resched ();
+  }
+}
+
+
+/*--------------------------- rt_edf_wait -----------------------------------*/
+
+void rt_edf_wait (void) {
+  /* The running task is done with its job: wait for the next release.    */
+  P_TCB p_task = os_tsk.run;
+  U32   now = os_time;
+
+  if ((S32)(now - p_task->edf_dl) > 0) {
+    /* Done after the tick of its deadline */
+    p_task->edf_miss++;
+  }
+  p_task->edf_rel += p_task->edf_period;
+  p_task->edf_dl   = p_task->edf_rel + p_task->edf_dline;
+  if ((S32)(p_task->edf_rel - now) > 0) {
+    rt_block (p_task->edf_rel - now, WAIT_ITV);
+  }
+  else {
+    /* Overrun: the next job is already released, with a later deadline */
+    rt_edf_resched ();
+  }
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
@@ -38,6 +38,7 @@
 #include "rt_Event.h"
 #include "rt_List.h"
 #include "rt_Task.h"
+#include "rt_Wait.h"
 #include "rt_HAL_CM.h"
 
 
@@ -48,10 +49,11 @@
 
 /*--------------------------- rt_evt_wait -----------------------------------*/
 
-OS_RESULT rt_evt_wait (U16 wait_flags, U16 timeout, BOOL and_wait) {
+OS_RESULT rt_evt_wait (U16 wait_flags, U32 timeout, BOOL and_wait) {
   /* Wait for one or more event flags with optional time-out.                */
   /* "wait_flags" identifies the flags to wait for.                          */
-  /* "timeout" is the time-out limit in system ticks (0xffff if no time-out) */
+  /* "timeout" is the time-out limit in system ticks (0xffffffff if no      */
+  /* time-out)                                                               */
   /* "and_wait" specifies the AND-ing of "wait_flags" as condition to be met */
   /* to complete the wait. (OR-ing if set to 0).                             */
   U32 block_state;
@@ -115,6 +117,15 @@ wkup: p_tcb->events &= ~event_flags;
       rt_dispatch (p_tcb);
     }
   }
+#ifdef CONFIG_RTX_WAIT_ANY
+  if (p_tcb->state == WAIT_ANY) {
+    /* Check for event flags of a multi-object wait */
+    if (p_tcb->events & event_flags) {
+      rt_wait_sig (p_tcb);
+      rt_dispatch (p_tcb);
+    }
+  }
+#endif
 }
 
 
@@ -141,6 +152,14 @@ void isr_evt_set (U16 event_flags, OS_TID task_id) {
   if (p_tcb == NULL) {
     return;
   }
+#ifdef CONFIG_RTX_PSQ_COALESCE
+  if (rt_fetch_or16 (&p_tcb->isr_events, event_flags) != 0U) {
+    /* An entry for this task is queued and not taken yet: */
+    /* the flags are picked up with it.                     */
+    rt_inc (&os_psqs.merged);
+    return;
+  }
+#endif
   rt_psq_enq (p_tcb, event_flags);
   rt_psh_req ();
 }
@@ -183,6 +202,15 @@ rdy:  p_CB->events &= ~event_flags;
       rt_put_prio (&os_rdy, p_CB);
     }
   }
+#ifdef CONFIG_RTX_WAIT_ANY
+  if (p_CB->state == WAIT_ANY) {
+    /* Check for event flags of a multi-object wait */
+    if (p_CB->events & event_flags) {
+      rt_wait_sig (p_CB);
+      rt_put_prio (&os_rdy, p_CB);
+    }
+  }
+#endif
 }
 
 /*----------------------------------------------------------------------------
@@ -33,7 +33,7 @@
  *---------------------------------------------------------------------------*/
 
 /* Functions */
-extern OS_RESULT rt_evt_wait (U16 wait_flags,  U16 timeout, BOOL and_wait);
+extern OS_RESULT rt_evt_wait (U16 wait_flags,  U32 timeout, BOOL and_wait);
 extern void      rt_evt_set  (U16 event_flags, OS_TID task_id);
 extern void      rt_evt_clr  (U16 clear_flags, OS_TID task_id);
 extern void      isr_evt_set (U16 event_flags, OS_TID task_id);
@@ -0,0 +1,219 @@
+/*----------------------------------------------------------------------------
+ *      CMSIS-RTOS  -  RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_EVTGROUP.C
+ *      Purpose: Event groups shared by several tasks
+ *      Rev.:    V4.79
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2015 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_System.h"
+#include "rt_List.h"
+#include "rt_Task.h"
+#include "rt_EvtGroup.h"
+#include "rt_HAL_CM.h"
+
+/*----------------------------------------------------------------------------
+ *      An event group holds 32 flags that any number of tasks wait for,
+ *      each for any or all of its own set. A waiting task keeps its flags
+ *      in 'msg' and its wait mode in 'waits'. Setting flags wakes every
+ *      task whose wait is met in one pass over the wait list; all of them
+ *      see the same flags and the ones they consume are cleared after the
+ *      pass, so one set works as a broadcast. Flags are written by tasks
+ *      in the kernel only, ISRs set them through the post service queue.
+ *---------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------
+ *      Functions
+ *---------------------------------------------------------------------------*/
+
+
+/*--------------------------- rt_egrp_met -----------------------------------*/
+
+static BOOL rt_egrp_met (U32 flags, U32 wait_flags, U32 mode) {
+  /* Check whether "flags" meet a wait for "wait_flags" in "mode". */
+  if (mode & OS_EGRP_ALL) {
+    return ((flags & wait_flags) == wait_flags);
+  }
+  return ((flags & wait_flags) != 0U);
+}
+
+
+/*--------------------------- rt_egrp_wake ----------------------------------*/
+
+static void rt_egrp_wake (P_EGRP p_EG) {
+  /* Put all tasks whose wait is met into the ready list. */
+  P_TCB p_TCB, p_next;
+  U32   flags = p_EG->flags;
+  U32   clr   = 0U;
+
+  for (p_TCB = p_EG->p_lnk; p_TCB != NULL; p_TCB = p_next) {
+    p_next = p_TCB->p_lnk;
+    if (rt_egrp_met (flags, (U32)p_TCB->msg, p_TCB->waits)) {
+      if ((p_TCB->waits & OS_EGRP_NOCLR) == 0U) {
+        clr |= (U32)p_TCB->msg;
+      }
+      rt_rmv_list (p_TCB);
+      p_TCB->p_lnk  = NULL;
+      p_TCB->p_rlnk = NULL;
+      rt_rmv_dly (p_TCB);
+      p_TCB->state  = READY;
+      rt_ret_val (p_TCB, flags);
+      rt_put_prio (&os_rdy, p_TCB);
+    }
+  }
+  p_EG->flags = flags & ~clr;
+}
+
+
+/*--------------------------- rt_egrp_preempt -------------------------------*/
+
+static void rt_egrp_preempt (void) {
+  /* Switch to the best of the tasks woken, if it is better. */
+  if ((rt_rdy_first() != NULL) && (rt_rdy_prio() > os_tsk.run->prio)) {
+    rt_put_prio (&os_rdy, os_tsk.run);
+    os_tsk.run->state = READY;
+    rt_dispatch (NULL);
+  }
+}
+
+
+/*--------------------------- rt_egrp_init ----------------------------------*/
+
+void rt_egrp_init (OS_ID egrp) {
+  /* Initialize an event group with all flags cleared */
+  P_EGRP p_EG = egrp;
+
+  p_EG->cb_type = EGCB;
+  p_EG->p_lnk   = NULL;
+  p_EG->flags   = 0U;
+}
+
+
+/*--------------------------- rt_egrp_wait ----------------------------------*/
+
+U32 rt_egrp_wait (OS_ID egrp, U32 flags, U32 mode, U32 timeout) {
+  /* Wait for any or all of "flags", see OS_EGRP_ALL. Returns the flags of  */
+  /* the group that met the wait, before they were cleared, or 0.           */
+  P_EGRP p_EG = egrp;
+  U32    cur  = p_EG->flags;
+
+  if (rt_egrp_met (cur, flags, mode)) {
+    if ((mode & OS_EGRP_NOCLR) == 0U) {
+      p_EG->flags = cur & ~flags;
+    }
+    return (cur);
+  }
+  if (timeout == 0U) {
+    return (0U);
+  }
+  if (p_EG->p_lnk != NULL) {
+    rt_put_prio ((P_XCB)p_EG, os_tsk.run);
+  }
+  else {
+    p_EG->p_lnk = os_tsk.run;
+    os_tsk.run->p_lnk  = NULL;
+    os_tsk.run->p_rlnk = (P_TCB)p_EG;
+  }
+  os_tsk.run->msg   = (void **)flags;
+  os_tsk.run->waits = (U16)mode;
+  rt_block (timeout, WAIT_EGRP);
+  return (0U);
+}
+
+
+/*--------------------------- rt_egrp_set -----------------------------------*/
+
+void rt_egrp_set (OS_ID egrp, U32 flags) {
+  /* Set "flags" and wake all tasks whose wait is met */
+  P_EGRP p_EG = egrp;
+
+  p_EG->flags |= flags;
+  if (p_EG->p_lnk != NULL) {
+    rt_egrp_wake (p_EG);
+    rt_egrp_preempt ();
+  }
+}
+
+
+/*--------------------------- rt_egrp_clr -----------------------------------*/
+
+U32 rt_egrp_clr (OS_ID egrp, U32 flags) {
+  /* Clear "flags", return the flags before */
+  P_EGRP p_EG = egrp;
+  U32    cur  = p_EG->flags;
+
+  p_EG->flags = cur & ~flags;
+  return (cur);
+}
+
+
+/*--------------------------- rt_egrp_delete --------------------------------*/
+
+void rt_egrp_delete (OS_ID egrp) {
+  /* Delete an event group, its waiting tasks get 0 */
+  P_EGRP p_EG = egrp;
+  P_TCB  p_TCB;
+
+  while (p_EG->p_lnk != NULL) {
+    p_TCB = rt_get_first ((P_XCB)p_EG);
+    rt_ret_val (p_TCB, 0U);
+    rt_rmv_dly (p_TCB);
+    p_TCB->state = READY;
+    rt_put_prio (&os_rdy, p_TCB);
+  }
+  rt_egrp_preempt ();
+  p_EG->cb_type = 0U;
+}
+
+
+/*--------------------------- isr_egrp_set ----------------------------------*/
+
+void isr_egrp_set (OS_ID egrp, U32 flags) {
+  /* Same function as "rt_egrp_set", but to be called by ISRs. */
+  rt_psq_enq (egrp, flags);
+  rt_psh_req ();
+}
+
+
+/*--------------------------- rt_egrp_psh -----------------------------------*/
+
+void rt_egrp_psh (P_EGRP p_CB, U32 flags) {
+  /* Set the flags posted by an ISR and wake the tasks whose wait is met */
+  p_CB->flags |= flags;
+  if (p_CB->p_lnk != NULL) {
+    rt_egrp_wake (p_CB);
+  }
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
@@ -38,6 +38,9 @@
 #include "rt_List.h"
 #include "rt_Task.h"
 #include "rt_Time.h"
+#include "rt_Trace.h"
+#include "rt_Wait.h"
+#include "rt_Edf.h"
 #include "rt_HAL_CM.h"
 
 /*----------------------------------------------------------------------------
@@ -46,8 +49,16 @@
 
 /* List head of chained ready tasks */
 struct OS_XCB  os_rdy;
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+/* Bitmap indexed ready queue, one FIFO per priority level */
+struct OS_RDYQ os_rdyq;
+#endif
 /* List head of chained delay tasks */
 struct OS_XCB  os_dly;
+#ifdef CONFIG_RTX_DLY_WHEEL
+/* Hashed timing wheel of delayed tasks */
+struct OS_DLYW os_dlyw;
+#endif
 
 
 /*----------------------------------------------------------------------------
@@ -55,6 +66,93 @@ struct OS_XCB  os_dly;
  *---------------------------------------------------------------------------*/
 
 
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+
+/* Ready queue level of a priority: the top level collects all priorities */
+/* above, tasks on it are kept sorted by priority.                        */
+#define rt_rdyq_lvl(prio) (((prio) < (OS_RDYQ_LVLS-1U)) ? (prio) : (OS_RDYQ_LVLS-1U))
+
+/*--------------------------- rt_rdyq_ins -----------------------------------*/
+
+static void rt_rdyq_ins (U32 lvl, P_TCB p_prev, P_TCB p_task) {
+  /* Link task "p_task" into ready FIFO "lvl" after "p_prev" (NULL: head).  */
+  P_TCB p_next;
+
+  if (p_prev == NULL) {
+    p_next = os_rdyq.first[lvl];
+    os_rdyq.first[lvl] = p_task;
+  }
+  else {
+    p_next = p_prev->p_lnk;
+    p_prev->p_lnk = p_task;
+  }
+  if (p_next == NULL) {
+    os_rdyq.last[lvl] = p_task;
+  }
+  else {
+    p_next->p_qlnk = p_task;
+  }
+  p_task->p_lnk   = p_next;
+  p_task->p_qlnk  = p_prev;
+  p_task->p_rlnk  = NULL;
+  p_task->rdy_lvl = (U8)lvl;
+  os_rdyq.map    |= (1U << lvl);
+}
+
+
+/*--------------------------- rt_rdyq_rmv -----------------------------------*/
+
+static void rt_rdyq_rmv (P_TCB p_task) {
+  /* Unlink task "p_task" from its ready FIFO.                              */
+  U32 lvl = p_task->rdy_lvl;
+
+  if (p_task->p_qlnk == NULL) {
+    os_rdyq.first[lvl] = p_task->p_lnk;
+  }
+  else {
+    p_task->p_qlnk->p_lnk = p_task->p_lnk;
+  }
+  if (p_task->p_lnk == NULL) {
+    os_rdyq.last[lvl] = p_task->p_qlnk;
+  }
+  else {
+    p_task->p_lnk->p_qlnk = p_task->p_qlnk;
+  }
+  if (os_rdyq.first[lvl] == NULL) {
+    os_rdyq.map &= ~(1U << lvl);
+  }
+  p_task->p_lnk  = NULL;
+  p_task->p_qlnk = NULL;
+}
+
+
+/*--------------------------- rt_rdyq_init ----------------------------------*/
+
+void rt_rdyq_init (void) {
+  /* Initialize an empty ready queue. */
+  U32 lvl;
+
+  os_rdyq.map = 0U;
+  for (lvl = 0U; lvl < OS_RDYQ_LVLS; lvl++) {
+    os_rdyq.first[lvl] = NULL;
+    os_rdyq.last[lvl]  = NULL;
+  }
+}
+
+
+/*--------------------------- rt_rdy_first ----------------------------------*/
+
+P_TCB rt_rdy_first (void) {
+  /* Return the highest priority ready task without removing it, or NULL.  */
+  if (os_rdyq.map == 0U) {
+    return (NULL);
+  }
+  return (os_rdyq.first[rt_msb (os_rdyq.map)]);
+}
+
+#endif
+
+
 /*--------------------------- rt_put_prio -----------------------------------*/
 
 void rt_put_prio (P_XCB p_CB, P_TCB p_task) {
@@ -65,13 +163,49 @@ void rt_put_prio (P_XCB p_CB, P_TCB p_task) {
   U32 prio;
   BOOL sem_mbx = __FALSE;
 
-  if ((p_CB->cb_type == SCB) || (p_CB->cb_type == MCB) || (p_CB->cb_type == MUCB)) {
+#ifdef CONFIG_RTX_TRACE
+  if ((p_CB == &os_rdy) && (p_task != os_tsk.run)) {
+    /* Woken up, or put back after a priority change */
+    rt_trc_put (OS_TRC_READY, p_task->task_id, os_tsk.run->task_id);
+  }
+#endif
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+  if (p_CB == &os_rdy) {
+    /* Append to the FIFO of its level, search only on the shared top level */
+    prio  = rt_rdyq_lvl (p_task->prio);
+    p_CB2 = os_rdyq.last[prio];
+    if (prio == (OS_RDYQ_LVLS-1U)) {
+      while ((p_CB2 != NULL) && (p_CB2->prio < p_task->prio)) {
+        p_CB2 = p_CB2->p_qlnk;
+      }
+    }
+#ifdef CONFIG_RTX_EDF
+    else if (prio == CONFIG_RTX_EDF_PRIO) {
+      /* The EDF band is ordered by deadline */
+      while ((p_CB2 != NULL) && rt_edf_before (p_task, p_CB2)) {
+        p_CB2 = p_CB2->p_qlnk;
+      }
+    }
+#endif
+    rt_rdyq_ins (prio, p_CB2, p_task);
+    return;
+  }
+#endif
+  if ((p_CB->cb_type == SCB) || (p_CB->cb_type == MCB) || (p_CB->cb_type == MUCB) ||
+      (p_CB->cb_type == MBFCB) || (p_CB->cb_type == EGCB)) {
     sem_mbx = __TRUE;
   }
   prio = p_task->prio;
   p_CB2 = p_CB->p_lnk;
   /* Search for an entry in the list */
   while ((p_CB2 != NULL) && (prio <= p_CB2->prio)) {
+#ifdef CONFIG_RTX_EDF
+    if ((prio == p_CB2->prio) &&
+        rt_edf_before (rt_edf_owner (p_task), rt_edf_owner (p_CB2))) {
+      /* The EDF band is ordered by deadline */
+      break;
+    }
+#endif
     p_CB = (P_XCB)p_CB2;
     p_CB2 = p_CB2->p_lnk;
   }
@@ -97,9 +231,17 @@ P_TCB rt_get_first (P_XCB p_CB) {
   /* "p_CB" points to head of list. */
   P_TCB p_first;
 
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+  if (p_CB == &os_rdy) {
+    p_first = os_rdyq.first[rt_msb (os_rdyq.map)];
+    rt_rdyq_rmv (p_first);
+    return (p_first);
+  }
+#endif
   p_first = p_CB->p_lnk;
   p_CB->p_lnk = p_first->p_lnk;
-  if ((p_CB->cb_type == SCB) || (p_CB->cb_type == MCB) || (p_CB->cb_type == MUCB)) {
+  if ((p_CB->cb_type == SCB) || (p_CB->cb_type == MCB) || (p_CB->cb_type == MUCB) ||
+      (p_CB->cb_type == MBFCB) || (p_CB->cb_type == EGCB)) {
     if (p_first->p_lnk != NULL) {
       p_first->p_lnk->p_rlnk = (P_TCB)p_CB;
       p_first->p_lnk = NULL;
@@ -118,9 +260,38 @@ P_TCB rt_get_first (P_XCB p_CB) {
 void rt_put_rdy_first (P_TCB p_task) {
   /* Put task identified with "p_task" at the head of the ready list. The   */
   /* task must have at least a priority equal to highest priority in list.  */
+#ifdef CONFIG_RTX_EDF
+  P_XCB p_CB  = &os_rdy;
+  P_TCB p_CB2 = os_rdy.p_lnk;
+
+  if (rt_edf_task (p_task)) {
+    /* Stays ahead of the tasks of the band with the same or later deadline */
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+    p_CB = NULL;
+    p_CB2 = os_rdyq.first[CONFIG_RTX_EDF_PRIO];
+#endif
+    while ((p_CB2 != NULL) && (p_CB2->prio == p_task->prio) &&
+           rt_edf_before (p_CB2, p_task)) {
+      p_CB  = (P_XCB)p_CB2;
+      p_CB2 = p_CB2->p_lnk;
+    }
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+    rt_rdyq_ins (CONFIG_RTX_EDF_PRIO, (P_TCB)p_CB, p_task);
+#else
+    p_task->p_lnk  = p_CB2;
+    p_task->p_rlnk = NULL;
+    p_CB->p_lnk    = p_task;
+#endif
+    return;
+  }
+#endif
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+  rt_rdyq_ins (rt_rdyq_lvl (p_task->prio), NULL, p_task);
+#else
   p_task->p_lnk = os_rdy.p_lnk;
   p_task->p_rlnk = NULL;
   os_rdy.p_lnk = p_task;
+#endif
 }
 
 
@@ -131,11 +302,19 @@ P_TCB rt_get_same_rdy_prio (void) {
   /* wise return NULL.                                                      */
   P_TCB p_first;
 
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+  p_first = rt_rdy_first ();
+  if ((p_first != NULL) && (p_first->prio == os_tsk.run->prio)) {
+    rt_rdyq_rmv (p_first);
+    return (p_first);
+  }
+#else
   p_first = os_rdy.p_lnk;
   if (p_first->prio == os_tsk.run->prio) {
     os_rdy.p_lnk = os_rdy.p_lnk->p_lnk;
     return (p_first);
   }
+#endif
   return (NULL);
 }
 
@@ -146,6 +325,13 @@ void rt_resort_prio (P_TCB p_task) {
   /* Re-sort ordered lists after the priority of 'p_task' has changed.      */
   P_TCB p_CB;
 
+#ifdef CONFIG_RTX_WAIT_ANY
+  if (p_task->state == WAIT_ANY) {
+    /* Task is queued on its objects by wait nodes. */
+    rt_wait_resort (p_task);
+    return;
+  }
+#endif
   if (p_task->p_rlnk == NULL) {
     if (p_task->state == READY) {
       /* Task is chained into READY list. */
@@ -155,7 +341,11 @@ void rt_resort_prio (P_TCB p_task) {
   }
   else {
     p_CB = p_task->p_rlnk;
+#ifdef CONFIG_RTX_WAIT_ANY
+    while ((p_CB->cb_type == TCB) || (p_CB->cb_type == WCB)) {
+#else
     while (p_CB->cb_type == TCB) {
+#endif
       /* Find a header of this task chain list. */
       p_CB = p_CB->p_rlnk;
     }
@@ -165,13 +355,130 @@ res:rt_rmv_list (p_task);
 }
 
 
+/*--------------------------- rt_dly_rel ------------------------------------*/
+
+static void rt_dly_rel (P_TCB p_rdy) {
+  /* Release task "p_rdy" whose delay has expired into the ready list.      */
+  TRC_EVENT(OS_TRC_TIMEOUT, p_rdy->task_id, p_rdy->state);
+#ifdef CONFIG_RTX_WAIT_ANY
+  if (p_rdy->state == WAIT_ANY) {
+    /* Take the wait nodes of the task out of the object wait lists */
+    rt_wait_cancel (p_rdy);
+  }
+#endif
+  if (p_rdy->p_rlnk != NULL) {
+    /* Task is really enqueued, remove task from semaphore/mailbox */
+    /* timeout waiting list. */
+    p_rdy->p_rlnk->p_lnk = p_rdy->p_lnk;
+    if (p_rdy->p_lnk != NULL) {
+      p_rdy->p_lnk->p_rlnk = p_rdy->p_rlnk;
+      p_rdy->p_lnk = NULL;
+    }
+    p_rdy->p_rlnk = NULL;
+  }
+  rt_put_prio (&os_rdy, p_rdy);
+  if (p_rdy->state == WAIT_ITV) {
+    /* Calculate the next time for interval wait. */
+    p_rdy->delta_time = p_rdy->interval_time + os_time;
+  }
+  p_rdy->state = READY;
+}
+
+#ifdef CONFIG_RTX_DLY_WHEEL
+
+/* A delayed task is hashed into slot "expiry time % OS_DLYW_SLOTS" and   */
+/* keeps the absolute expiry time in "delta_time". The first task of a    */
+/* slot chain has "p_blnk" pointing to the "os_dly" list head.            */
+/* Timeouts run up to 2^32 ticks, so a task due in a later turn of the    */
+/* wheel is passed over once per turn. That costs one compare every       */
+/* OS_DLYW_SLOTS ticks; cascading levels would move the task instead.     */
+#define rt_dlyw_slot(time) ((U32)(time) & (OS_DLYW_SLOTS-1U))
+
+/*--------------------------- rt_dlyw_init ----------------------------------*/
+
+void rt_dlyw_init (void) {
+  /* Initialize an empty timing wheel. */
+  U32 i;
+
+  os_dlyw.cnt = 0U;
+  for (i = 0U; i < OS_DLYW_SLOTS; i++) {
+    os_dlyw.slot[i] = NULL;
+  }
+}
+
+
+/*--------------------------- rt_dlyw_unlink --------------------------------*/
+
+static void rt_dlyw_unlink (P_TCB p_task) {
+  /* Unlink task "p_task" from its timing wheel slot chain.                 */
+  if (p_task->p_blnk == (P_TCB)&os_dly) {
+    os_dlyw.slot[rt_dlyw_slot (p_task->delta_time)] = p_task->p_dlnk;
+  }
+  else {
+    p_task->p_blnk->p_dlnk = p_task->p_dlnk;
+  }
+  if (p_task->p_dlnk != NULL) {
+    p_task->p_dlnk->p_blnk = p_task->p_blnk;
+    p_task->p_dlnk = NULL;
+  }
+  p_task->p_blnk = NULL;
+  os_dlyw.cnt--;
+}
+
+
+/*--------------------------- rt_dly_next -----------------------------------*/
+
+U32 rt_dly_next (void) {
+  /* Return number of ticks until the first delay expires, 0xFFFFFFFF if   */
+  /* none.                                                                 */
+  P_TCB p;
+  U32 i,delta,next = 0xFFFFFFFFU;
+
+  if (os_dlyw.cnt == 0U) {
+    return (next);
+  }
+  /* A task due within one wheel turn sits in the slot of its delay, so   */
+  /* the scan stops at the first slot holding a task due in this turn.    */
+  for (i = 1U; i <= OS_DLYW_SLOTS; i++) {
+    for (p = os_dlyw.slot[rt_dlyw_slot (os_time + i)]; p != NULL; p = p->p_dlnk) {
+      delta = p->delta_time - os_time;
+      if (delta < next) {
+        next = delta;
+      }
+    }
+    if (next <= i) {
+      break;
+    }
+  }
+  return (next);
+}
+
+#endif
+
+
 /*--------------------------- rt_put_dly ------------------------------------*/
 
-void rt_put_dly (P_TCB p_task, U16 delay) {
+void rt_put_dly (P_TCB p_task, U32 delay) {
   /* Put a task identified with "p_task" into chained delay wait list using */
   /* a delay value of "delay".                                              */
+#ifdef CONFIG_RTX_DLY_WHEEL
   P_TCB p;
-  U32 delta,idelay = delay;
+  U32 slot;
+
+  /* Push task at the head of the slot it expires in. */
+  p_task->delta_time = os_time + delay;
+  slot = rt_dlyw_slot (p_task->delta_time);
+  p = os_dlyw.slot[slot];
+  p_task->p_dlnk = p;
+  p_task->p_blnk = (P_TCB)&os_dly;
+  if (p != NULL) {
+    p->p_blnk = p_task;
+  }
+  os_dlyw.slot[slot] = p_task;
+  os_dlyw.cnt++;
+#else
+  P_TCB p;
+  U32 delta;
 
   p = (P_TCB)&os_dly;
   if (p->p_dlnk == NULL) {
@@ -180,13 +487,13 @@ void rt_put_dly (P_TCB p_task, U16 delay) {
     goto last;
   }
   delta = os_dly.delta_time;
-  while (delta < idelay) {
+  while (delta < delay) {
     if (p->p_dlnk == NULL) {
       /* End of list found */
 last: p_task->p_dlnk = NULL;
       p->p_dlnk = p_task;
       p_task->p_blnk = p;
-      p->delta_time = (U16)(idelay - delta);
+      p->delta_time = delay - delta;
       p_task->delta_time = 0U;
       return;
     }
@@ -200,8 +507,9 @@ last: p_task->p_dlnk = NULL;
   if (p_task->p_dlnk != NULL) {
     p_task->p_dlnk->p_blnk = p_task;
   }
-  p_task->delta_time = (U16)(delta - idelay);
+  p_task->delta_time = delta - delay;
   p->delta_time -= p_task->delta_time;
+#endif
 }
 
 
@@ -211,29 +519,31 @@ void rt_dec_dly (void) {
   /* Decrement delta time of list head: remove tasks having a value of zero.*/
   P_TCB p_rdy;
 
+#ifdef CONFIG_RTX_DLY_WHEEL
+  P_TCB p_next;
+
+  /* Release in one pass all tasks of the current slot due at this tick. */
+  if (os_dlyw.cnt == 0U) {
+    return;
+  }
+  p_rdy = os_dlyw.slot[rt_dlyw_slot (os_time)];
+  while (p_rdy != NULL) {
+    p_next = p_rdy->p_dlnk;
+    if (p_rdy->delta_time == os_time) {
+      rt_dlyw_unlink (p_rdy);
+      rt_dly_rel (p_rdy);
+    }
+    p_rdy = p_next;
+  }
+#else
   if (os_dly.p_dlnk == NULL) {
     return;
   }
   os_dly.delta_time--;
   while ((os_dly.delta_time == 0U) && (os_dly.p_dlnk != NULL)) {
     p_rdy = os_dly.p_dlnk;
-    if (p_rdy->p_rlnk != NULL) {
-      /* Task is really enqueued, remove task from semaphore/mailbox */
-      /* timeout waiting list. */
-      p_rdy->p_rlnk->p_lnk = p_rdy->p_lnk;
-      if (p_rdy->p_lnk != NULL) {
-        p_rdy->p_lnk->p_rlnk = p_rdy->p_rlnk;
-        p_rdy->p_lnk = NULL;
-      }
-      p_rdy->p_rlnk = NULL;
-    }
-    rt_put_prio (&os_rdy, p_rdy);
     os_dly.delta_time = p_rdy->delta_time;
-    if (p_rdy->state == WAIT_ITV) {
-      /* Calculate the next time for interval wait. */
-      p_rdy->delta_time = p_rdy->interval_time + (U16)os_time;
-    }
-    p_rdy->state   = READY;
+    rt_dly_rel (p_rdy);
     os_dly.p_dlnk = p_rdy->p_dlnk;
     if (p_rdy->p_dlnk != NULL) {
       p_rdy->p_dlnk->p_blnk = (P_TCB)&os_dly;
@@ -241,6 +551,7 @@ void rt_dec_dly (void) {
     }
     p_rdy->p_blnk = NULL;
   }
+#endif
 }
 
 
@@ -260,6 +571,13 @@ void rt_rmv_list (P_TCB p_task) {
     return;
   }
 
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+  (void)p_b;
+  if ((p_task->p_qlnk != NULL) || (os_rdyq.first[p_task->rdy_lvl] == p_task)) {
+    /* A task is enqueued in the ready queue. */
+    rt_rdyq_rmv (p_task);
+  }
+#else
   p_b = (P_TCB)&os_rdy;
   while (p_b != NULL) {
     /* Search the ready list for task "p_task" */
@@ -269,6 +587,7 @@ void rt_rmv_list (P_TCB p_task) {
     }
     p_b = p_b->p_lnk;
   }
+#endif
 }
 
 
@@ -279,6 +598,12 @@ void rt_rmv_dly (P_TCB p_task) {
   P_TCB p_b;
 
   p_b = p_task->p_blnk;
+#ifdef CONFIG_RTX_DLY_WHEEL
+  if (p_b != NULL) {
+    /* Task is really enqueued */
+    rt_dlyw_unlink (p_task);
+  }
+#else
   if (p_b != NULL) {
     /* Task is really enqueued */
     p_b->p_dlnk = p_task->p_dlnk;
@@ -294,6 +619,7 @@ void rt_rmv_dly (P_TCB p_task) {
     }
     p_task->p_blnk = NULL;
   }
+#endif
 }
 
 
@@ -301,14 +627,63 @@ void rt_rmv_dly (P_TCB p_task) {
 
 void rt_psq_enq (OS_ID entry, U32 arg) {
   /* Insert post service request "entry" into ps-queue. */
-  U32 idx;
+  U32 idx, cnt;
 
+#ifdef CONFIG_RTX_TRACE
+  if (((P_XCB)entry)->cb_type == TCB) {
+    rt_trc_put (OS_TRC_POST, TCB, ((P_TCB)entry)->task_id);
+  }
+  else {
+    rt_trc_put (OS_TRC_POST, ((P_XCB)entry)->cb_type, (U32)entry >> 2);
+  }
+#endif
   idx = rt_inc_qi (os_psq->size, &os_psq->count, &os_psq->first);
   if (idx < os_psq->size) {
     os_psq->q[idx].id  = entry;
     os_psq->q[idx].arg = arg;
+    rt_inc (&os_psqs.posts);
+    /* Only PendSV takes entries out, it cannot run before this ISR ends */
+    cnt = os_psq->count;
+    if (cnt > os_psqs.peak) {
+      os_psqs.peak = cnt;
+    }
+  }
+  else {
+    /* Counted first, so that os_error() can report it */
+    rt_inc (&os_psqs.ovf);
+    os_error (OS_ERR_FIFO_OVF);
+  }
+}
+
+
+/*--------------------------- rt_psq_enq_n ----------------------------------*/
+
+void rt_psq_enq_n (OS_ID entry, U32 *args, U32 cnt) {
+  /* Insert "cnt" post arguments for "entry" into ps-queue as one request:  */
+  /* a header with the count, then the arguments packed two per entry.     */
+  U32 idx, cnt_q, i, n;
+
+#ifdef CONFIG_RTX_TRACE
+  rt_trc_put (OS_TRC_POST, ((P_XCB)entry)->cb_type, (U32)entry >> 2);
+#endif
+  n = 1U + ((cnt + 1U) >> 1);
+  idx = rt_add_qi (os_psq->size, &os_psq->count, &os_psq->first, n);
+  if (idx < os_psq->size) {
+    os_psq->q[idx].id  = (void *)((U32)entry | OS_PSQ_BATCH);
+    os_psq->q[idx].arg = cnt;
+    for (i = 0U; i < cnt; i += 2U) {
+      if (++idx == os_psq->size) { idx = 0U; }
+      os_psq->q[idx].id  = (void *)args[i];
+      os_psq->q[idx].arg = (i + 1U < cnt) ? args[i+1U] : 0U;
+    }
+    rt_inc (&os_psqs.posts);
+    cnt_q = os_psq->count;
+    if (cnt_q > os_psqs.peak) {
+      os_psqs.peak = cnt_q;
+    }
   }
   else {
+    rt_inc (&os_psqs.ovf);
     os_error (OS_ERR_FIFO_OVF);
   }
 }
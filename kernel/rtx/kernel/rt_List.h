@@ -40,10 +40,22 @@
 #define SCB             2U
 #define MUCB            3U
 #define HCB             4U
+#define MBFCB           5U
+#define WCB             6U
+#define EGCB            7U
+
+/* Tag of the 'id' of a ps-queue entry that heads a batch of posts */
+#define OS_PSQ_BATCH    1U
 
 /* Variables */
 extern struct OS_XCB os_rdy;
 extern struct OS_XCB os_dly;
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+extern struct OS_RDYQ os_rdyq;
+#endif
+#ifdef CONFIG_RTX_DLY_WHEEL
+extern struct OS_DLYW os_dlyw;
+#endif
 
 /* Functions */
 extern void  rt_put_prio      (P_XCB p_CB, P_TCB p_task);
@@ -51,14 +63,26 @@ extern P_TCB rt_get_first     (P_XCB p_CB);
 extern void  rt_put_rdy_first (P_TCB p_task);
 extern P_TCB rt_get_same_rdy_prio (void);
 extern void  rt_resort_prio   (P_TCB p_task);
-extern void  rt_put_dly       (P_TCB p_task, U16 delay);
+extern void  rt_put_dly       (P_TCB p_task, U32 delay);
 extern void  rt_dec_dly       (void);
 extern void  rt_rmv_list      (P_TCB p_task);
 extern void  rt_rmv_dly       (P_TCB p_task);
 extern void  rt_psq_enq       (OS_ID entry, U32 arg);
+extern void  rt_psq_enq_n     (OS_ID entry, U32 *args, U32 cnt);
+#ifdef CONFIG_RTX_DLY_WHEEL
+extern void  rt_dlyw_init     (void);
+extern U32   rt_dly_next      (void);
+#endif
 
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+extern void  rt_rdyq_init     (void);
+extern P_TCB rt_rdy_first     (void);
+#define rt_rdy_prio(void) (rt_rdy_first()->prio)
+#else
 /* This is a fast macro generating in-line code */
+#define rt_rdy_first(void) (os_rdy.p_lnk)
 #define rt_rdy_prio(void) (os_rdy.p_lnk->prio)
+#endif
 
 /*----------------------------------------------------------------------------
  * end of file
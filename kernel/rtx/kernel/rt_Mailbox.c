@@ -37,6 +37,7 @@
 #include "rt_System.h"
 #include "rt_List.h"
 #include "rt_Mailbox.h"
+#include "rt_Wait.h"
 #include "rt_MemBox.h"
 #include "rt_Task.h"
 #include "rt_HAL_CM.h"
@@ -67,7 +68,7 @@ void rt_mbx_init (OS_ID mailbox, U16 mbx_size) {
 
 /*--------------------------- rt_mbx_send -----------------------------------*/
 
-OS_RESULT rt_mbx_send (OS_ID mailbox, void *p_msg, U16 timeout) {
+OS_RESULT rt_mbx_send (OS_ID mailbox, void *p_msg, U32 timeout) {
   /* Send message to a mailbox */
   P_MCB p_MCB = mailbox;
   P_TCB p_TCB;
@@ -75,6 +76,9 @@ OS_RESULT rt_mbx_send (OS_ID mailbox, void *p_msg, U16 timeout) {
   if ((p_MCB->p_lnk != NULL) && (p_MCB->state == 1U)) {
     /* A task is waiting for message */
     p_TCB = rt_get_first ((P_XCB)p_MCB);
+#ifdef CONFIG_RTX_WAIT_ANY
+    p_TCB = rt_wait_take (p_TCB, (U32)p_msg);
+#endif
 #ifdef __CMSIS_RTOS
     rt_ret_val2(p_TCB, 0x10U/*osEventMessage*/, (U32)p_msg);
 #else
@@ -120,7 +124,7 @@ OS_RESULT rt_mbx_send (OS_ID mailbox, void *p_msg, U16 timeout) {
 
 /*--------------------------- rt_mbx_wait -----------------------------------*/
 
-OS_RESULT rt_mbx_wait (OS_ID mailbox, void **message, U16 timeout) {
+OS_RESULT rt_mbx_wait (OS_ID mailbox, void **message, U32 timeout) {
   /* Receive a message; possibly wait for it */
   P_MCB p_MCB = mailbox;
   P_TCB p_TCB;
@@ -174,6 +178,87 @@ OS_RESULT rt_mbx_wait (OS_ID mailbox, void **message, U16 timeout) {
 }
 
 
+/*--------------------------- rt_mbx_preempt --------------------------------*/
+
+#ifdef __CMSIS_RTOS
+static void rt_mbx_preempt (void) {
+  /* Switch to the best of the tasks woken by a batch, if it is better. */
+  if ((rt_rdy_first() != NULL) && (rt_rdy_prio() > os_tsk.run->prio)) {
+    rt_put_prio (&os_rdy, os_tsk.run);
+    os_tsk.run->state = READY;
+    rt_dispatch (NULL);
+  }
+}
+
+
+/*--------------------------- rt_mbx_send_n ---------------------------------*/
+
+U32 rt_mbx_send_n (OS_ID mailbox, const U32 *p_msg, U32 cnt) {
+  /* Send up to "cnt" messages without waiting, return how many were sent. */
+  /* Every task waiting for a message gets one and is woken once.          */
+  P_MCB p_MCB = mailbox;
+  P_TCB p_TCB;
+  U32   n = 0U;
+
+  while ((n < cnt) && (p_MCB->p_lnk != NULL) && (p_MCB->state == 1U)) {
+    p_TCB = rt_get_first ((P_XCB)p_MCB);
+#ifdef CONFIG_RTX_WAIT_ANY
+    p_TCB = rt_wait_take (p_TCB, p_msg[n]);
+#endif
+    rt_ret_val2(p_TCB, 0x10U/*osEventMessage*/, p_msg[n++]);
+    rt_rmv_dly (p_TCB);
+    p_TCB->state = READY;
+    rt_put_prio (&os_rdy, p_TCB);
+  }
+  /* Store the rest in the mailbox queue */
+  while ((n < cnt) && (p_MCB->count < p_MCB->size)) {
+    p_MCB->msg[p_MCB->first] = (void *)p_msg[n++];
+    rt_inc (&p_MCB->count);
+    if (++p_MCB->first == p_MCB->size) {
+      p_MCB->first = 0U;
+    }
+  }
+  rt_mbx_preempt ();
+  return (n);
+}
+
+
+/*--------------------------- rt_mbx_wait_n ---------------------------------*/
+
+U32 rt_mbx_wait_n (OS_ID mailbox, U32 *message, U32 cnt) {
+  /* Receive up to "cnt" messages without waiting, return how many. Tasks  */
+  /* waiting to send refill the freed entries and are woken once.          */
+  P_MCB p_MCB = mailbox;
+  P_TCB p_TCB;
+  U32   n = 0U;
+
+  while ((n < cnt) && (p_MCB->count != 0U)) {
+    message[n++] = (U32)p_MCB->msg[p_MCB->last];
+    if (++p_MCB->last == p_MCB->size) {
+      p_MCB->last = 0U;
+    }
+    if ((p_MCB->p_lnk != NULL) && (p_MCB->state == 2U)) {
+      /* A task is waiting to send message */
+      p_TCB = rt_get_first ((P_XCB)p_MCB);
+      rt_ret_val(p_TCB, 0U/*osOK*/);
+      p_MCB->msg[p_MCB->first] = p_TCB->msg;
+      if (++p_MCB->first == p_MCB->size) {
+        p_MCB->first = 0U;
+      }
+      rt_rmv_dly (p_TCB);
+      p_TCB->state = READY;
+      rt_put_prio (&os_rdy, p_TCB);
+    }
+    else {
+      rt_dec (&p_MCB->count);
+    }
+  }
+  rt_mbx_preempt ();
+  return (n);
+}
+#endif
+
+
 /*--------------------------- rt_mbx_check ----------------------------------*/
 
 OS_RESULT rt_mbx_check (OS_ID mailbox) {
@@ -196,6 +281,17 @@ void isr_mbx_send (OS_ID mailbox, void *p_msg) {
 }
 
 
+/*--------------------------- isr_mbx_send_n --------------------------------*/
+
+void isr_mbx_send_n (OS_ID mailbox, U32 *p_msg, U32 cnt) {
+  /* Post "cnt" messages from an ISR as one entry of the ps-queue. */
+  P_MCB p_MCB = mailbox;
+
+  rt_psq_enq_n (p_MCB, p_msg, cnt);
+  rt_psh_req ();
+}
+
+
 /*--------------------------- isr_mbx_receive -------------------------------*/
 
 OS_RESULT isr_mbx_receive (OS_ID mailbox, void **message) {
@@ -261,6 +357,9 @@ void rt_mbx_psh (P_MCB p_CB, void *p_msg) {
     case 1:
       /* Task is waiting for a message, pass the message to the task directly */
       p_TCB = rt_get_first ((P_XCB)p_CB);
+#ifdef CONFIG_RTX_WAIT_ANY
+      p_TCB = rt_wait_take (p_TCB, (U32)p_msg);
+#endif
 #ifdef __CMSIS_RTOS
       rt_ret_val2(p_TCB, 0x10U/*osEventMessage*/, (U32)p_msg);
 #else
@@ -34,10 +34,13 @@
 
 /* Functions */
 extern void      rt_mbx_init  (OS_ID mailbox, U16 mbx_size);
-extern OS_RESULT rt_mbx_send  (OS_ID mailbox, void *p_msg,    U16 timeout);
-extern OS_RESULT rt_mbx_wait  (OS_ID mailbox, void **message, U16 timeout);
+extern OS_RESULT rt_mbx_send  (OS_ID mailbox, void *p_msg,    U32 timeout);
+extern OS_RESULT rt_mbx_wait  (OS_ID mailbox, void **message, U32 timeout);
+extern U32       rt_mbx_send_n (OS_ID mailbox, const U32 *p_msg, U32 cnt);
+extern U32       rt_mbx_wait_n (OS_ID mailbox, U32 *message,    U32 cnt);
 extern OS_RESULT rt_mbx_check (OS_ID mailbox);
 extern void      isr_mbx_send (OS_ID mailbox, void *p_msg);
+extern void      isr_mbx_send_n (OS_ID mailbox, U32 *p_msg, U32 cnt);
 extern OS_RESULT isr_mbx_receive (OS_ID mailbox, void **message);
 extern void      rt_mbx_psh   (P_MCB p_CB,    void *p_msg);
 
@@ -97,12 +97,12 @@ void *rt_alloc_box (void *box_mem) {
 #ifndef __USE_EXCLUSIVE_ACCESS
   U32  irq_mask;
 
-  irq_mask = (U32)__disable_irq ();
+  irq_mask = rt_irq_lock ();
   free = ((P_BM) box_mem)->free;
   if (free) {
     ((P_BM) box_mem)->free = *free;
   }
-  if (irq_mask == 0U) { __enable_irq (); }
+  rt_irq_unlock (irq_mask);
 #else
   do {
     if ((free = (void **)__ldrex(&((P_BM) box_mem)->free)) == 0U) {
@@ -148,10 +148,10 @@ U32 rt_free_box (void *box_mem, void *box) {
   }
 
 #ifndef __USE_EXCLUSIVE_ACCESS
-  irq_mask = (U32)__disable_irq ();
+  irq_mask = rt_irq_lock ();
   *((void **)box) = ((P_BM) box_mem)->free;
   ((P_BM) box_mem)->free = box;
-  if (irq_mask == 0U) { __enable_irq (); }
+  rt_irq_unlock (irq_mask);
 #else
   do {
     do {
@@ -0,0 +1,341 @@
+/*----------------------------------------------------------------------------
+ *      CMSIS-RTOS  -  RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_MSGBUF.C
+ *      Purpose: Zero-copy message buffers
+ *      Rev.:    V4.79
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2015 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_System.h"
+#include "rt_List.h"
+#include "rt_Task.h"
+#include "rt_MsgBuf.h"
+#include "rt_HAL_CM.h"
+
+/*----------------------------------------------------------------------------
+ *      A message buffer is a ring of variable length records in one data
+ *      area. A record is a length word followed by the data, padded to a
+ *      word, and never wraps: when it does not fit up to the end of the
+ *      area, the rest is marked with OS_MBF_PAD and the record goes to the
+ *      start. 'head' is written by the writer only, 'tail' by the reader
+ *      only and the area between them is never full up, so one writer (a
+ *      task or an ISR) and one reader task work on it without a lock. The
+ *      kernel is only entered to block the reader and to wake it up.
+ *---------------------------------------------------------------------------*/
+
+#define MBF_SIZE(len)   (4U + (((len) + 3U) & ~3U))
+#define MBF_NONE        0xFFFFFFFFU
+
+
+/*----------------------------------------------------------------------------
+ *      Functions
+ *---------------------------------------------------------------------------*/
+
+
+/*--------------------------- rt_mbf_init -----------------------------------*/
+
+void rt_mbf_init (OS_ID mbf, U32 size) {
+  /* Initialize a message buffer with a data area of "size" bytes */
+  P_MBF p_MBF = mbf;
+
+  p_MBF->cb_type   = MBFCB;
+  p_MBF->state     = 0U;
+  p_MBF->p_lnk     = NULL;
+  p_MBF->size      = size & ~3U;
+  p_MBF->head      = 0U;
+  p_MBF->resv      = MBF_NONE;
+  p_MBF->resv_len  = 0U;
+  p_MBF->bytes_in  = 0U;
+  p_MBF->recs_in   = 0U;
+  p_MBF->tail      = 0U;
+  p_MBF->bytes_out = 0U;
+  p_MBF->recs_out  = 0U;
+}
+
+
+/*--------------------------- rt_mbf_reserve --------------------------------*/
+
+void *rt_mbf_reserve (OS_ID mbf, U32 len) {
+  /* Reserve room for a record of "len" bytes, return where to write its   */
+  /* data or NULL when the buffer has no contiguous room for it. Called by */
+  /* the writer, a later reserve replaces the one not yet committed.        */
+  P_MBF p_MBF = mbf;
+  U32   head  = p_MBF->head;
+  U32   tail  = p_MBF->tail;
+  U32   size  = p_MBF->size;
+  U32   need, off;
+
+  if (len > size) {
+    return (NULL);
+  }
+  need = MBF_SIZE(len);
+  if (head >= tail) {
+    /* Free are the end of the area and the start up to the tail */
+    if ((need < (size - head)) || ((need == (size - head)) && (tail != 0U))) {
+      off = head;
+    }
+    else if (need < tail) {
+      off = 0U;
+    }
+    else {
+      return (NULL);
+    }
+  }
+  else if (need < (tail - head)) {
+    off = head;
+  }
+  else {
+    return (NULL);
+  }
+  p_MBF->resv     = off;
+  p_MBF->resv_len = len;
+  return (&p_MBF->data[(off >> 2) + 1U]);
+}
+
+
+/*--------------------------- rt_mbf_commit ---------------------------------*/
+
+OS_RESULT rt_mbf_commit (OS_ID mbf, U32 len) {
+  /* Pass the first "len" bytes of the reserved record to the reader. */
+  P_MBF p_MBF = mbf;
+  U32   off   = p_MBF->resv;
+  U32   head  = p_MBF->head;
+
+  if ((off == MBF_NONE) || (len > p_MBF->resv_len)) {
+    return (OS_R_NOK);
+  }
+  if (off != head) {
+    /* The record went to the start, skip the end of the area */
+    p_MBF->data[head >> 2] = OS_MBF_PAD;
+  }
+  p_MBF->data[off >> 2] = len;
+  p_MBF->resv = MBF_NONE;
+  head = off + MBF_SIZE(len);
+  if (head == p_MBF->size) {
+    head = 0U;
+  }
+  /* Record before head, head before the counts the reader waits on */
+  __DMB();
+  p_MBF->head     = head;
+  p_MBF->bytes_in = p_MBF->bytes_in + len;
+  p_MBF->recs_in  = p_MBF->recs_in + 1U;
+  return (OS_R_OK);
+}
+
+
+/*--------------------------- rt_mbf_ready ----------------------------------*/
+
+static BOOL rt_mbf_ready (P_MBF p_MBF) {
+  /* Check if the data the reader waits for is there */
+  if ((p_MBF->wait_bytes != 0U) &&
+      ((p_MBF->bytes_in - p_MBF->bytes_out) >= p_MBF->wait_bytes)) {
+    return (__TRUE);
+  }
+  if ((p_MBF->wait_recs != 0U) &&
+      ((p_MBF->recs_in - p_MBF->recs_out) >= p_MBF->wait_recs)) {
+    return (__TRUE);
+  }
+  return (__FALSE);
+}
+
+
+/*--------------------------- rt_mbf_due ------------------------------------*/
+
+U32 rt_mbf_due (OS_ID mbf) {
+  /* Check after a commit if the reader has to be woken up. The reader     */
+  /* sets 'state' before it checks the counts in the kernel, so either it  */
+  /* sees the new counts or the writer sees 'state'.                        */
+  P_MBF p_MBF = mbf;
+
+  if (p_MBF->state == 0U) {
+    return (0U);
+  }
+  return (rt_mbf_ready (p_MBF));
+}
+
+
+/*--------------------------- rt_mbf_peek -----------------------------------*/
+
+void *rt_mbf_peek (OS_ID mbf, U32 *len) {
+  /* Return the data and length of the oldest record, NULL when empty. */
+  P_MBF p_MBF = mbf;
+  U32   tail  = p_MBF->tail;
+  U32   hdr;
+
+  if (tail == p_MBF->head) {
+    return (NULL);
+  }
+  __DMB();
+  hdr = p_MBF->data[tail >> 2];
+  if (hdr == OS_MBF_PAD) {
+    tail = 0U;
+    hdr  = p_MBF->data[0];
+  }
+  *len = hdr;
+  return (&p_MBF->data[(tail >> 2) + 1U]);
+}
+
+
+/*--------------------------- rt_mbf_release --------------------------------*/
+
+OS_RESULT rt_mbf_release (OS_ID mbf) {
+  /* Give the room of the oldest record back to the writer. */
+  P_MBF p_MBF = mbf;
+  U32   tail  = p_MBF->tail;
+  U32   hdr;
+
+  if (tail == p_MBF->head) {
+    return (OS_R_NOK);
+  }
+  __DMB();
+  hdr = p_MBF->data[tail >> 2];
+  if (hdr == OS_MBF_PAD) {
+    tail = 0U;
+    hdr  = p_MBF->data[0];
+  }
+  tail += MBF_SIZE(hdr);
+  if (tail == p_MBF->size) {
+    tail = 0U;
+  }
+  p_MBF->bytes_out = p_MBF->bytes_out + hdr;
+  p_MBF->recs_out  = p_MBF->recs_out + 1U;
+  /* Done with the record before the writer may reuse it */
+  __DMB();
+  p_MBF->tail = tail;
+  return (OS_R_OK);
+}
+
+
+/*--------------------------- rt_mbf_count ----------------------------------*/
+
+U32 rt_mbf_count (OS_ID mbf, U32 *recs) {
+  /* Return the number of bytes and of records to be read. */
+  P_MBF p_MBF = mbf;
+  U32   bytes;
+
+  bytes = p_MBF->bytes_in - p_MBF->bytes_out;
+  if (recs != NULL) {
+    *recs = p_MBF->recs_in - p_MBF->recs_out;
+  }
+  return (bytes);
+}
+
+
+/*--------------------------- rt_mbf_wait -----------------------------------*/
+
+OS_RESULT rt_mbf_wait (OS_ID mbf, U32 bytes, U32 recs, U32 timeout) {
+  /* Wait until "bytes" bytes or "recs" records can be read, a count of 0  */
+  /* is not waited for. Only one task may wait.                             */
+  P_MBF p_MBF = mbf;
+
+  if (p_MBF->p_lnk != NULL) {
+    return (OS_R_NOK);
+  }
+  p_MBF->wait_bytes = bytes;
+  p_MBF->wait_recs  = recs;
+  p_MBF->state      = 1U;
+  __DMB();
+  if (rt_mbf_ready (p_MBF)) {
+    p_MBF->state = 0U;
+    return (OS_R_OK);
+  }
+  if (timeout == 0U) {
+    p_MBF->state = 0U;
+    return (OS_R_TMO);
+  }
+  /* A wait that times out leaves 'state' set, the next wake up clears it */
+  p_MBF->p_lnk = os_tsk.run;
+  os_tsk.run->p_lnk  = NULL;
+  os_tsk.run->p_rlnk = (P_TCB)p_MBF;
+  rt_block (timeout, WAIT_MBF);
+  return (OS_R_TMO);
+}
+
+
+/*--------------------------- rt_mbf_take -----------------------------------*/
+
+static P_TCB rt_mbf_take (P_MBF p_MBF) {
+  /* Take the waiting reader off the buffer when its data is there. */
+  P_TCB p_TCB;
+
+  if (p_MBF->p_lnk == NULL) {
+    p_MBF->state = 0U;
+    return (NULL);
+  }
+  if (rt_mbf_ready (p_MBF) == __FALSE) {
+    return (NULL);
+  }
+  p_MBF->state = 0U;
+  p_TCB = rt_get_first ((P_XCB)p_MBF);
+  rt_ret_val (p_TCB, OS_R_OK);
+  rt_rmv_dly (p_TCB);
+  return (p_TCB);
+}
+
+
+/*--------------------------- rt_mbf_wake -----------------------------------*/
+
+void rt_mbf_wake (OS_ID mbf) {
+  /* Wake up the reader after a commit of a writer task. */
+  P_TCB p_TCB;
+
+  p_TCB = rt_mbf_take (mbf);
+  if (p_TCB != NULL) {
+    rt_dispatch (p_TCB);
+  }
+}
+
+
+/*--------------------------- isr_mbf_wake ----------------------------------*/
+
+void isr_mbf_wake (OS_ID mbf) {
+  /* Same function as "rt_mbf_wake", but to be called by ISRs. */
+  rt_psq_enq (mbf, 0U);
+  rt_psh_req ();
+}
+
+
+/*--------------------------- rt_mbf_psh ------------------------------------*/
+
+void rt_mbf_psh (P_MBF p_CB) {
+  /* Wake up the reader after a commit of an ISR. */
+  P_TCB p_TCB;
+
+  p_TCB = rt_mbf_take (p_CB);
+  if (p_TCB != NULL) {
+    p_TCB->state = READY;
+    rt_put_prio (&os_rdy, p_TCB);
+  }
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
@@ -0,0 +1,55 @@
+/*----------------------------------------------------------------------------
+ *      CMSIS-RTOS  -  RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_MSGBUF.H
+ *      Purpose: Zero-copy message buffers definitions
+ *      Rev.:    V4.79
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2015 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+/* Length word of the unused end of the data area, the record is at 0 */
+#define OS_MBF_PAD      0xFFFFFFFFU
+
+#ifdef CONFIG_RTX_MSGBUF
+/* Functions */
+extern void      rt_mbf_init    (OS_ID mbf, U32 size);
+extern void     *rt_mbf_reserve (OS_ID mbf, U32 len);
+extern OS_RESULT rt_mbf_commit  (OS_ID mbf, U32 len);
+extern U32       rt_mbf_due     (OS_ID mbf);
+extern void     *rt_mbf_peek    (OS_ID mbf, U32 *len);
+extern OS_RESULT rt_mbf_release (OS_ID mbf);
+extern U32       rt_mbf_count   (OS_ID mbf, U32 *recs);
+extern OS_RESULT rt_mbf_wait    (OS_ID mbf, U32 bytes, U32 recs, U32 timeout);
+extern void      rt_mbf_wake    (OS_ID mbf);
+extern void      isr_mbf_wake   (OS_ID mbf);
+extern void      rt_mbf_psh     (P_MBF p_CB);
+#endif
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
@@ -37,6 +37,7 @@
 #include "rt_List.h"
 #include "rt_Task.h"
 #include "rt_Mutex.h"
+#include "rt_Trace.h"
 #include "rt_HAL_CM.h"
 
 
@@ -69,7 +70,7 @@ OS_RESULT rt_mut_delete (OS_ID mutex) {
   P_MUCB p_mlnk;
   U8     prio;
 
-  if (p_MCB->level != 0U) {
+  if (p_MCB->owner != NULL) {
 
     p_TCB = p_MCB->owner;
 
@@ -98,7 +99,14 @@ OS_RESULT rt_mut_delete (OS_ID mutex) {
       }
       p_mlnk = p_mlnk->p_mlnk;
     }
+#ifdef CONFIG_RTX_PREEMPT_THR
+    if ((p_TCB == os_tsk.run) && (prio < p_TCB->prio_thr)) {
+      /* Keeps running at its preemption threshold */
+      prio = p_TCB->prio_thr;
+    }
+#endif
     if (p_TCB->prio != prio) {
+      TRC_EVENT(OS_TRC_PRIO, p_TCB->task_id, ((U32)p_TCB->prio << 8) | prio);
       p_TCB->prio = prio;
       if (p_TCB != os_tsk.run) {
         rt_resort_prio (p_TCB);
@@ -116,7 +124,7 @@ OS_RESULT rt_mut_delete (OS_ID mutex) {
     rt_put_prio (&os_rdy, p_TCB);
   }
 
-  if ((os_rdy.p_lnk != NULL) && (os_rdy.p_lnk->prio > os_tsk.run->prio)) {
+  if ((rt_rdy_first() != NULL) && (rt_rdy_prio() > os_tsk.run->prio)) {
     /* preempt running task */
     rt_put_prio (&os_rdy, os_tsk.run);
     os_tsk.run->state = READY;
@@ -172,6 +180,15 @@ OS_RESULT rt_mut_release (OS_ID mutex) {
     }
     p_mlnk = p_mlnk->p_mlnk;
   }
+#ifdef CONFIG_RTX_PREEMPT_THR
+  if (prio < os_tsk.run->prio_thr) {
+    /* Keeps running at its preemption threshold */
+    prio = os_tsk.run->prio_thr;
+  }
+#endif
+  if (os_tsk.run->prio != prio) {
+    TRC_EVENT(OS_TRC_PRIO, os_tsk.run->task_id, ((U32)os_tsk.run->prio << 8) | prio);
+  }
   os_tsk.run->prio = prio;
 
   if (p_MCB->p_lnk != NULL) {
@@ -202,6 +219,7 @@ OS_RESULT rt_mut_release (OS_ID mutex) {
     }
   }
   else {
+    p_MCB->owner = NULL;
     /* Check if own priority lowered by priority inversion. */
     if (rt_rdy_prio() > os_tsk.run->prio) {
       rt_put_prio (&os_rdy, os_tsk.run);
@@ -215,11 +233,12 @@ OS_RESULT rt_mut_release (OS_ID mutex) {
 
 /*--------------------------- rt_mut_wait -----------------------------------*/
 
-OS_RESULT rt_mut_wait (OS_ID mutex, U16 timeout) {
+OS_RESULT rt_mut_wait (OS_ID mutex, U32 timeout) {
   /* Wait for a mutex, continue when mutex is free. */
   P_MUCB p_MCB = mutex;
 
-  if (p_MCB->level == 0U) {
+  if (p_MCB->owner == NULL) {
+    /* Free mutex: the owner is also the lock word of the fast path. */
     p_MCB->owner  = os_tsk.run;
     p_MCB->p_mlnk = os_tsk.run->p_mlnk;
     os_tsk.run->p_mlnk = p_MCB; 
@@ -241,6 +260,8 @@ OS_RESULT rt_mut_wait (OS_ID mutex, U16 timeout) {
   /* Raise the owner task priority if lower than current priority. */
   /* This priority inversion is called priority inheritance.       */
   if (p_MCB->owner->prio < os_tsk.run->prio) {
+    TRC_EVENT(OS_TRC_PRIO, p_MCB->owner->task_id,
+              ((U32)p_MCB->owner->prio << 8) | os_tsk.run->prio);
     p_MCB->owner->prio = os_tsk.run->prio;
     rt_resort_prio (p_MCB->owner);
   }
@@ -57,6 +57,9 @@ __weak void rt_init_robin (void) {
   /* Initialize Round Robin variables. */
   os_robin.task = NULL;
   os_robin.tout = (U16)os_rrobin;
+#ifdef CONFIG_RTX_ROBIN_SLICE
+  os_robin.off  = 0U;
+#endif
 }
 
 /*--------------------------- rt_chk_robin ----------------------------------*/
@@ -64,12 +67,29 @@ __weak void rt_init_robin (void) {
 __weak void rt_chk_robin (void) {
   /* Check if Round Robin timeout expired and switch to the next ready task.*/
   P_TCB p_new;
+#ifdef CONFIG_RTX_ROBIN_SLICE
+  P_TCB p_run = rt_rdy_first();
 
-  if (os_robin.task != os_rdy.p_lnk) {
+  /* The running task was put first: a peer is ready right behind it. */
+  if ((p_run->p_lnk == NULL) || (p_run->p_lnk->prio != p_run->prio) ||
+      ((p_run->prio < 32U) && ((os_robin.off & (1U << p_run->prio)) != 0U))) {
+    /* Nothing to share the CPU with, a slice starts when a peer shows up. */
+    os_robin.task = NULL;
+    return;
+  }
+  if (os_robin.task != p_run) {
+    /* New task was suspended, start its own time slice. */
+    os_robin.task = p_run;
+    os_robin.time = (U16)os_time +
+                    ((p_run->slice != 0U) ? p_run->slice : os_robin.tout) - 1U;
+  }
+#else
+  if (os_robin.task != rt_rdy_first()) {
     /* New task was suspended, reset Round Robin timeout. */
-    os_robin.task = os_rdy.p_lnk;
+    os_robin.task = rt_rdy_first();
     os_robin.time = (U16)os_time + os_robin.tout - 1U;
   }
+#endif
   if (os_robin.time == (U16)os_time) {
     /* Round Robin timeout has expired, swap Robin tasks. */
     os_robin.task = NULL;
@@ -78,6 +98,35 @@ __weak void rt_chk_robin (void) {
   }
 }
 
+#ifdef CONFIG_RTX_ROBIN_SLICE
+/*--------------------------- rt_robin_slice --------------------------------*/
+
+void rt_robin_slice (P_TCB p_task, U16 slice) {
+  /* Set the time slice of a task, 0 for the default of OS_ROBINTOUT. It is */
+  /* used from the next slice the task starts.                              */
+  p_task->slice = slice;
+}
+
+/*--------------------------- rt_robin_prio ---------------------------------*/
+
+OS_RESULT rt_robin_prio (U8 prio, BOOL on) {
+  /* Turn Round Robin on or off for the tasks of priority "prio".           */
+  if (prio >= 32U) {
+    return (OS_R_NOK);
+  }
+  if (on) {
+    os_robin.off &= ~(1U << prio);
+  }
+  else {
+    os_robin.off |= (1U << prio);
+    if ((os_robin.task != NULL) && (os_robin.task->prio == prio)) {
+      os_robin.task = NULL;
+    }
+  }
+  return (OS_R_OK);
+}
+#endif
+
 /*----------------------------------------------------------------------------
  * end of file
  *---------------------------------------------------------------------------*/
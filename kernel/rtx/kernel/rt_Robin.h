@@ -38,6 +38,10 @@ extern struct OS_ROBIN os_robin;
 /* Functions */
 extern void rt_init_robin (void);
 extern void rt_chk_robin  (void);
+#ifdef CONFIG_RTX_ROBIN_SLICE
+extern void      rt_robin_slice (P_TCB p_task, U16 slice);
+extern OS_RESULT rt_robin_prio  (U8 prio, BOOL on);
+#endif
 
 /*----------------------------------------------------------------------------
  * end of file
@@ -38,6 +38,7 @@
 #include "rt_List.h"
 #include "rt_Task.h"
 #include "rt_Semaphore.h"
+#include "rt_Wait.h"
 #include "rt_HAL_CM.h"
 
 
@@ -55,6 +56,9 @@ void rt_sem_init (OS_ID semaphore, U16 token_count) {
   p_SCB->cb_type = SCB;
   p_SCB->p_lnk  = NULL;
   p_SCB->tokens = token_count;
+#ifdef CONFIG_RTX_PSQ_COALESCE
+  p_SCB->isr_tokens = 0U;
+#endif
 }
 
 
@@ -69,13 +73,16 @@ OS_RESULT rt_sem_delete (OS_ID semaphore) {
   while (p_SCB->p_lnk != NULL) {
     /* A task is waiting for token */
     p_TCB = rt_get_first ((P_XCB)p_SCB);
+#ifdef CONFIG_RTX_WAIT_ANY
+    p_TCB = rt_wait_take (p_TCB, 0U);
+#endif
     rt_ret_val(p_TCB, 0U);
     rt_rmv_dly(p_TCB);
     p_TCB->state = READY;
     rt_put_prio (&os_rdy, p_TCB);
   }
 
-  if ((os_rdy.p_lnk != NULL) && (os_rdy.p_lnk->prio > os_tsk.run->prio)) {
+  if ((rt_rdy_first() != NULL) && (rt_rdy_prio() > os_tsk.run->prio)) {
     /* preempt running task */
     rt_put_prio (&os_rdy, os_tsk.run);
     os_tsk.run->state = READY;
@@ -99,6 +106,9 @@ OS_RESULT rt_sem_send (OS_ID semaphore) {
   if (p_SCB->p_lnk != NULL) {
     /* A task is waiting for token */
     p_TCB = rt_get_first ((P_XCB)p_SCB);
+#ifdef CONFIG_RTX_WAIT_ANY
+    p_TCB = rt_wait_take (p_TCB, 1U);
+#endif
 #ifdef __CMSIS_RTOS
     rt_ret_val(p_TCB, 1U);
 #else
@@ -117,7 +127,7 @@ OS_RESULT rt_sem_send (OS_ID semaphore) {
 
 /*--------------------------- rt_sem_wait -----------------------------------*/
 
-OS_RESULT rt_sem_wait (OS_ID semaphore, U16 timeout) {
+OS_RESULT rt_sem_wait (OS_ID semaphore, U32 timeout) {
   /* Obtain a token; possibly wait for it */
   P_SCB p_SCB = semaphore;
 
@@ -148,6 +158,14 @@ void isr_sem_send (OS_ID semaphore) {
   /* Same function as "os_sem_send", but to be called by ISRs */
   P_SCB p_SCB = semaphore;
 
+#ifdef CONFIG_RTX_PSQ_COALESCE
+  if (rt_fetch_inc16 (&p_SCB->isr_tokens) != 0U) {
+    /* An entry for this semaphore is queued and not taken yet: */
+    /* the token is picked up with it.                          */
+    rt_inc (&os_psqs.merged);
+    return;
+  }
+#endif
   rt_psq_enq (p_SCB, 0U);
   rt_psh_req ();
 }
@@ -155,13 +173,16 @@ void isr_sem_send (OS_ID semaphore) {
 
 /*--------------------------- rt_sem_psh ------------------------------------*/
 
-void rt_sem_psh (P_SCB p_CB) {
-  /* Check if task has to be waken up */
+void rt_sem_psh (P_SCB p_CB, U32 tokens) {
+  /* Check if tasks have to be waken up */
   P_TCB p_TCB;
 
-  if (p_CB->p_lnk != NULL) {
+  while ((tokens != 0U) && (p_CB->p_lnk != NULL)) {
     /* A task is waiting for token */
     p_TCB = rt_get_first ((P_XCB)p_CB);
+#ifdef CONFIG_RTX_WAIT_ANY
+    p_TCB = rt_wait_take (p_TCB, 1U);
+#endif
     rt_rmv_dly (p_TCB);
     p_TCB->state   = READY;
 #ifdef __CMSIS_RTOS
@@ -170,11 +191,14 @@ void rt_sem_psh (P_SCB p_CB) {
     rt_ret_val(p_TCB, OS_R_SEM);
 #endif
     rt_put_prio (&os_rdy, p_TCB);
+    tokens--;
   }
-  else {
-    /* Store token */
-    p_CB->tokens++;
+  /* Store the tokens left, up to the maximum a nested ISR release may       */
+  /* have passed between its check and the post.                             */
+  if (tokens > (0xFFFFU - (U32)p_CB->tokens)) {
+    tokens = 0xFFFFU - (U32)p_CB->tokens;
   }
+  p_CB->tokens += (U16)tokens;
 }
 
 /*----------------------------------------------------------------------------
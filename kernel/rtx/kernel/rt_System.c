@@ -39,10 +39,13 @@
 #include "rt_Event.h"
 #include "rt_List.h"
 #include "rt_Mailbox.h"
+#include "rt_MsgBuf.h"
+#include "rt_EvtGroup.h"
 #include "rt_Semaphore.h"
 #include "rt_Time.h"
 #include "rt_Timer.h"
 #include "rt_Robin.h"
+#include "rt_Trace.h"
 #include "rt_HAL_CM.h"
 
 /*----------------------------------------------------------------------------
@@ -51,6 +54,23 @@
 
 S32 os_tick_irqn;
 
+/* Tickless idle statistics */
+U32 os_sleep_ticks;               /* Ticks spent in sleep since start        */
+U32 os_sleep_cnt;                 /* Number of sleeps since start            */
+
+/* ISR post service queue statistics */
+struct OS_PSQS os_psqs;
+
+#ifdef CONFIG_RTX_CPU_STAT
+/* CPU usage accounting */
+struct OS_CPU os_cpu;
+#endif
+
+#ifdef CONFIG_RTX_STK_WATERMARK
+/* Stack watermark scan */
+struct OS_STKW os_stkw;
+#endif
+
 /*----------------------------------------------------------------------------
  *      Local Variables
  *---------------------------------------------------------------------------*/
@@ -82,16 +102,20 @@ extern U32 sysUserTimerWakeupTime(void);
 
 U32 rt_suspend (void) {
   /* Suspend OS scheduler */
-  U32 delta = 0xFFFFU;
+  U32 delta = 0xFFFFFFFFU;
 #ifdef __CMSIS_RTOS
   U32 sleep;
 #endif
 
   rt_tsk_lock();
   
+#ifdef CONFIG_RTX_DLY_WHEEL
+  delta = rt_dly_next ();
+#else
   if (os_dly.p_dlnk) {
     delta = os_dly.delta_time;
   }
+#endif
 #ifdef __CMSIS_RTOS
   sleep = sysUserTimerWakeupTime();
   if (sleep < delta) { delta = sleep; }
@@ -100,6 +124,12 @@ U32 rt_suspend (void) {
     if (os_tmr.tcnt < delta) delta = os_tmr.tcnt;
   }
 #endif
+#ifdef CONFIG_RTX_CLOCK64
+  /* Wake up before the cycle counter can wrap behind the 64-bit clock.    */
+  if (delta > (0x80000000U / (os_trv + 1U))) {
+    delta = 0x80000000U / (os_trv + 1U);
+  }
+#endif
 
   return (delta);
 }
@@ -113,50 +143,61 @@ void rt_resume (U32 sleep_time) {
   /* Resume OS scheduler after suspend */
   P_TCB next;
   U32   delta;
+#ifdef CONFIG_RTX_DLY_WHEEL
+  U32   dly;
+#endif
 
   os_tsk.run->state = READY;
   rt_put_rdy_first (os_tsk.run);
 
   os_robin.task = NULL;
 
-  /* Update delays. */
-  if (os_dly.p_dlnk) {
-    delta = sleep_time;
-    if (delta >= os_dly.delta_time) {
-      delta   -= os_dly.delta_time;
-      os_time += os_dly.delta_time;
-      os_dly.delta_time = 1U;
-      while (os_dly.p_dlnk) {
-        rt_dec_dly();
-        if (delta == 0U) { break; }
-        delta--;
-        os_time++;
-      }
-    } else {
-      os_time           +=      delta;
-      os_dly.delta_time -= (U16)delta;
+  if (sleep_time != 0U) {
+    os_sleep_ticks += sleep_time;
+    os_sleep_cnt++;
+  }
+
+  /* Update delays: advance straight to each expiry within the sleep time, */
+  /* the work depends on the number of expired delays, not on sleep time.  */
+  delta = sleep_time;
+#ifdef CONFIG_RTX_DLY_WHEEL
+  while (delta != 0U) {
+    dly = rt_dly_next ();
+    if (dly > delta) {
+      break;
     }
-  } else {
-    os_time += sleep_time;
+    delta   -= dly;
+    os_time += dly;
+    rt_dec_dly ();
+  }
+#else
+  while ((os_dly.p_dlnk != NULL) && (delta >= os_dly.delta_time)) {
+    delta   -= os_dly.delta_time;
+    os_time += os_dly.delta_time;
+    os_dly.delta_time = 1U;
+    rt_dec_dly ();
+  }
+  if (os_dly.p_dlnk != NULL) {
+    os_dly.delta_time -= delta;
   }
+#endif
+  os_time += delta;
+#ifdef CONFIG_RTX_CLOCK64
+  rt_clk_sync ();
+#endif
 
   /* Check the user timers. */
 #ifdef __CMSIS_RTOS
   sysUserTimerUpdate(sleep_time);
 #else
-  if (os_tmr.next) {
-    delta = sleep_time;
-    if (delta >= os_tmr.tcnt) {
-      delta   -= os_tmr.tcnt;
-      os_tmr.tcnt = 1U;
-      while (os_tmr.next) {
-        rt_tmr_tick();
-        if (delta == 0U) { break; }
-        delta--;
-      }
-    } else {
-      os_tmr.tcnt -= delta;
-    }
+  delta = sleep_time;
+  while ((os_tmr.next != NULL) && (delta >= os_tmr.tcnt)) {
+    delta -= os_tmr.tcnt;
+    os_tmr.tcnt = 1U;
+    rt_tmr_tick ();
+  }
+  if (os_tmr.next != NULL) {
+    os_tmr.tcnt -= (U16)delta;
   }
 #endif
 
@@ -221,33 +262,77 @@ void rt_pop_req (void) {
   /* Process an ISR post service requests. */
   struct OS_XCB *p_CB;
   P_TCB next;
-  U32  idx;
+  U32  idx, cnt, i;
 
+#ifdef CONFIG_RTX_CPU_STAT
+  rt_cpu_irq_enter ();
+#endif
+  TRC_EVENT(OS_TRC_IRQ_IN, 0U, OS_TRC_PENDSV);
   os_tsk.run->state = READY;
   rt_put_rdy_first (os_tsk.run);
 
   idx = os_psq->last;
   while (os_psq->count) {
     p_CB = os_psq->q[idx].id;
-    if (p_CB->cb_type == TCB) {
+    if ((U32)p_CB & OS_PSQ_BATCH) {
+      /* Batch of mailbox posts, the messages follow two per entry */
+      p_CB = (struct OS_XCB *)((U32)p_CB & ~OS_PSQ_BATCH);
+      cnt = os_psq->q[idx].arg;
+      for (i = 0U; i < cnt; i++) {
+        if ((i & 1U) == 0U) {
+          if (++idx == os_psq->size) { idx = 0U; }
+          rt_dec (&os_psq->count);
+          rt_mbx_psh ((P_MCB)p_CB, os_psq->q[idx].id);
+        }
+        else {
+          rt_mbx_psh ((P_MCB)p_CB, (void *)os_psq->q[idx].arg);
+        }
+      }
+    }
+    else if (p_CB->cb_type == TCB) {
       /* Is of TCB type */
+#ifdef CONFIG_RTX_PSQ_COALESCE
+      /* Take all flags set since the entry was queued */
+      rt_evt_psh ((P_TCB)p_CB, (U16)rt_swap16 (&((P_TCB)p_CB)->isr_events, 0U));
+#else
       rt_evt_psh ((P_TCB)p_CB, (U16)os_psq->q[idx].arg);
+#endif
     }
     else if (p_CB->cb_type == MCB) {
       /* Is of MCB type */
       rt_mbx_psh ((P_MCB)p_CB, (void *)os_psq->q[idx].arg);
     }
+#ifdef CONFIG_RTX_MSGBUF
+    else if (p_CB->cb_type == MBFCB) {
+      /* Is of MBFCB type */
+      rt_mbf_psh ((P_MBF)p_CB);
+    }
+#endif
+#ifdef CONFIG_RTX_EVT_GROUP
+    else if (p_CB->cb_type == EGCB) {
+      /* Is of EGCB type */
+      rt_egrp_psh ((P_EGRP)p_CB, os_psq->q[idx].arg);
+    }
+#endif
     else {
       /* Must be of SCB type */
-      rt_sem_psh ((P_SCB)p_CB);
+#ifdef CONFIG_RTX_PSQ_COALESCE
+      rt_sem_psh ((P_SCB)p_CB, rt_swap16 (&((P_SCB)p_CB)->isr_tokens, 0U));
+#else
+      rt_sem_psh ((P_SCB)p_CB, 1U);
+#endif
     }
     if (++idx == os_psq->size) { idx = 0U; }
     rt_dec (&os_psq->count);
   }
-  os_psq->last = (U8)idx;
+  os_psq->last = (U16)idx;
 
   next = rt_get_first (&os_rdy);
   rt_switch_req (next);
+  TRC_EVENT(OS_TRC_IRQ_OUT, 0U, OS_TRC_PENDSV);
+#ifdef CONFIG_RTX_CPU_STAT
+  rt_cpu_irq_exit ();
+#endif
 }
 
 
@@ -279,6 +364,15 @@ __weak void os_tick_irqack (void) {
   /* Acknowledge timer interrupt. */
 }
 
+/*--------------------------- os_tick_sleep ---------------------------------*/
+
+__weak U32 os_tick_sleep (U32 ticks) {
+  /* Run SysTick as a one-shot timer up to the next kernel timeout "ticks"  */
+  /* away and wait for an interrupt. Return the number of elapsed ticks and */
+  /* leave SysTick running in phase, with its interrupt still locked.       */
+  return rt_systick_sleep(ticks);
+}
+
 
 /*--------------------------- rt_systick ------------------------------------*/
 
@@ -288,6 +382,10 @@ void rt_systick (void) {
   /* Check for system clock update, suspend running task. */
   P_TCB next;
 
+#ifdef CONFIG_RTX_CPU_STAT
+  rt_cpu_irq_enter ();
+#endif
+  TRC_EVENT(OS_TRC_IRQ_IN, 0U, OS_TRC_SYSTICK);
   os_tsk.run->state = READY;
   rt_put_rdy_first (os_tsk.run);
 
@@ -297,6 +395,15 @@ void rt_systick (void) {
   /* Update delays. */
   os_time++;
   rt_dec_dly ();
+#ifdef CONFIG_RTX_CLOCK64
+  rt_clk_sync ();
+#endif
+
+#ifdef CONFIG_RTX_CPU_STAT
+  if ((os_time - os_cpu.win_time) >= CONFIG_RTX_CPU_STAT_WINDOW) {
+    rt_cpu_window ();
+  }
+#endif
 
   /* Check the user timers. */
 #ifdef __CMSIS_RTOS
@@ -308,6 +415,10 @@ void rt_systick (void) {
   /* Switch back to highest ready task */
   next = rt_get_first (&os_rdy);
   rt_switch_req (next);
+  TRC_EVENT(OS_TRC_IRQ_OUT, 0U, OS_TRC_SYSTICK);
+#ifdef CONFIG_RTX_CPU_STAT
+  rt_cpu_irq_exit ();
+#endif
 }
 
 /*--------------------------- rt_stk_check ----------------------------------*/
@@ -320,6 +431,236 @@ __weak void rt_stk_check (void) {
   }
 }
 
+#ifdef CONFIG_RTX_STK_WATERMARK
+
+/*--------------------------- rt_stk_init -----------------------------------*/
+
+void rt_stk_init (void) {
+  /* Fill the free part of the MSP and start the first scan pass. */
+  os_stkw.idx      = 0U;
+  os_stkw.pos      = 0U;
+  os_stkw.msp_free = 0xFFFFU;
+  rt_msp_fill ();
+}
+
+/*--------------------------- rt_stk_words ----------------------------------*/
+
+static U32 rt_stk_words (P_TCB p_TCB) {
+  /* Words of the stack of "p_TCB" above the overflow check MAGIC_WORD. */
+  U32 size;
+
+  size = p_TCB->priv_stack;
+  if (size == 0U) {
+    size = (U16)os_stackinfo;
+  }
+  return ((size >> 2) - 1U);
+}
+
+/*--------------------------- rt_stk_area -----------------------------------*/
+
+static U32 *rt_stk_area (U32 idx, U32 *words) {
+  /* Stack "idx" of a scan pass: the tasks in 'os_active_TCB', then the    */
+  /* idle demon, then the MSP. Return its bottom, NULL for an empty slot.  */
+  P_TCB p_TCB;
+
+  if (idx < os_maxtaskrun) {
+    p_TCB = os_active_TCB[idx];
+    if (p_TCB == NULL) {
+      return (NULL);
+    }
+  }
+  else if (idx == os_maxtaskrun) {
+    p_TCB = &os_idle_TCB;
+  }
+  else {
+    return (rt_msp_area (words));
+  }
+  *words = rt_stk_words (p_TCB);
+  return (&p_TCB->stack[1]);
+}
+
+/*--------------------------- rt_stk_scan -----------------------------------*/
+
+U32 rt_stk_scan (void) {
+  /* Check the next OS_STKW_CHUNK words of the stack being scanned, from   */
+  /* its bottom up to the first one that lost the fill pattern. Return     */
+  /* __TRUE when this completed a pass over all stacks.                    */
+  U32 *stk,words,pos,end,idx;
+
+  idx = os_stkw.idx;
+  stk = rt_stk_area (idx, &words);
+  if (stk != NULL) {
+    pos = os_stkw.pos;
+    end = pos + OS_STKW_CHUNK;
+    if (end > words) {
+      end = words;
+    }
+    while ((pos < end) && (stk[pos] == MAGIC_PATTERN)) {
+      pos++;
+    }
+    if ((pos == end) && (end < words)) {
+      /* Untouched so far, go on with the next chunk */
+      os_stkw.pos = (U16)pos;
+      return (__FALSE);
+    }
+    if (idx < os_maxtaskrun) {
+      ((P_TCB)os_active_TCB[idx])->stk_free = pos;
+    }
+    else if (idx == os_maxtaskrun) {
+      os_idle_TCB.stk_free = pos;
+    }
+    else {
+      os_stkw.msp_free = pos;
+    }
+  }
+  os_stkw.pos = 0U;
+  if (idx > os_maxtaskrun) {
+    os_stkw.idx = 0U;
+    return (__TRUE);
+  }
+  os_stkw.idx = (U16)(idx + 1U);
+  return (__FALSE);
+}
+
+/*--------------------------- rt_stk_used -----------------------------------*/
+
+U32 rt_stk_used (P_TCB p_TCB, U32 *size) {
+  /* Return the bytes of stack used by task "p_TCB", or of the MSP when    */
+  /* NULL, as seen by the last scan. The whole stack size goes to "size".  */
+  U32 words,free;
+
+  if (p_TCB == NULL) {
+    if (rt_msp_area (&words) == NULL) {
+      *size = 0U;
+      return (0U);
+    }
+    free  = os_stkw.msp_free;
+    *size = words << 2;
+  }
+  else {
+    words = rt_stk_words (p_TCB);
+    free  = p_TCB->stk_free;
+    *size = (words + 1U) << 2;
+  }
+  if (free > words) {
+    free = words;
+  }
+  return ((words - free) << 2);
+}
+
+#endif
+
+#ifdef CONFIG_RTX_CPU_STAT
+
+/*--------------------------- rt_cpu_init -----------------------------------*/
+
+void rt_cpu_init (void) {
+  /* Start the cycle counter and the first load window. */
+  rt_cpu_start ();
+  os_cpu.stamp      = rt_cpu_cycles ();
+  os_cpu.nest       = 0U;
+  os_cpu.irq_cycles = 0U;
+  os_cpu.irq_mark   = 0U;
+  os_cpu.irq_load   = 0U;
+  os_cpu.win_start  = os_cpu.stamp;
+  os_cpu.win_len    = 0U;
+  os_cpu.win_time   = os_time;
+}
+
+/*--------------------------- rt_cpu_charge ---------------------------------*/
+
+static void rt_cpu_charge (void) {
+  /* Charge the cycles since the last charge to the running task, unless  */
+  /* an interrupt is counted. Interrupts must be disabled.                 */
+  U32 now;
+
+  if (os_cpu.nest == 0U) {
+    now = rt_cpu_cycles ();
+    if (os_tsk.run != NULL) {
+      os_tsk.run->cpu_cycles += now - os_cpu.stamp;
+    }
+    os_cpu.stamp = now;
+  }
+}
+
+/*--------------------------- rt_cpu_switch ---------------------------------*/
+
+void rt_cpu_switch (void) {
+  /* Charge the running task on a task switch request. Interrupts that    */
+  /* count themselves may preempt, so the charge is done with them off.   */
+  U32 lock = rt_irq_lock ();
+
+  rt_cpu_charge ();
+  rt_irq_unlock (lock);
+}
+
+/*--------------------------- rt_cpu_irq_enter ------------------------------*/
+
+void rt_cpu_irq_enter (void) {
+  /* Start counting interrupt time, the interrupted task is charged first. */
+  U32 lock = rt_irq_lock ();
+
+  rt_cpu_charge ();
+  os_cpu.nest++;
+  rt_irq_unlock (lock);
+}
+
+/*--------------------------- rt_cpu_irq_exit -------------------------------*/
+
+void rt_cpu_irq_exit (void) {
+  /* Charge the time since the outermost interrupt entry to the IRQ time.  */
+  U32 lock = rt_irq_lock ();
+  U32 now;
+
+  if (--os_cpu.nest == 0U) {
+    now = rt_cpu_cycles ();
+    os_cpu.irq_cycles += now - os_cpu.stamp;
+    os_cpu.stamp = now;
+  }
+  rt_irq_unlock (lock);
+}
+
+/*--------------------------- rt_cpu_window ---------------------------------*/
+
+void rt_cpu_window (void) {
+  /* Close the load window: record the cycles of every task, the idle task */
+  /* and the interrupts within it. Called from the tick interrupt, where   */
+  /* the IRQ time is counted, so nested interrupts leave all counts alone. */
+  P_TCB p_TCB;
+  U32 now,i;
+
+  now = rt_cpu_cycles ();
+  os_cpu.irq_cycles += now - os_cpu.stamp;
+  os_cpu.stamp = now;
+
+  for (i = 0U; i < os_maxtaskrun; i++) {
+    p_TCB = os_active_TCB[i];
+    if (p_TCB != NULL) {
+      p_TCB->cpu_load = p_TCB->cpu_cycles - p_TCB->cpu_mark;
+      p_TCB->cpu_mark = p_TCB->cpu_cycles;
+    }
+  }
+  os_idle_TCB.cpu_load = os_idle_TCB.cpu_cycles - os_idle_TCB.cpu_mark;
+  os_idle_TCB.cpu_mark = os_idle_TCB.cpu_cycles;
+  os_cpu.irq_load  = os_cpu.irq_cycles - os_cpu.irq_mark;
+  os_cpu.irq_mark  = os_cpu.irq_cycles;
+  os_cpu.win_len   = now - os_cpu.win_start;
+  os_cpu.win_start = now;
+  os_cpu.win_time  = os_time;
+}
+
+/*--------------------------- rt_cpu_used -----------------------------------*/
+
+U32 rt_cpu_used (P_TCB p_TCB) {
+  /* Return the cycles run by task "p_TCB", up to date for a running task. */
+  if (p_TCB == os_tsk.run) {
+    rt_cpu_switch ();
+  }
+  return (p_TCB->cpu_cycles);
+}
+
+#endif
+
 /*----------------------------------------------------------------------------
  * end of file
  *---------------------------------------------------------------------------*/
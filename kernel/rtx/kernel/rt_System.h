@@ -35,6 +35,15 @@
 /* Variables */
 #define os_psq  ((P_PSQ)&os_fifo)
 extern S32 os_tick_irqn;
+extern U32 os_sleep_ticks;
+extern U32 os_sleep_cnt;
+extern struct OS_PSQS os_psqs;
+#ifdef CONFIG_RTX_CPU_STAT
+extern struct OS_CPU os_cpu;
+#endif
+#ifdef CONFIG_RTX_STK_WATERMARK
+extern struct OS_STKW os_stkw;
+#endif
 
 /* Functions */
 extern U32  rt_suspend    (void);
@@ -45,6 +54,20 @@ extern void rt_psh_req    (void);
 extern void rt_pop_req    (void);
 extern void rt_systick    (void);
 extern void rt_stk_check  (void);
+extern U32  os_tick_sleep (U32 ticks);
+#ifdef CONFIG_RTX_CPU_STAT
+extern void rt_cpu_init      (void);
+extern void rt_cpu_switch    (void);
+extern void rt_cpu_irq_enter (void);
+extern void rt_cpu_irq_exit  (void);
+extern void rt_cpu_window    (void);
+extern U32  rt_cpu_used      (P_TCB p_TCB);
+#endif
+#ifdef CONFIG_RTX_STK_WATERMARK
+extern void rt_stk_init      (void);
+extern U32  rt_stk_scan      (void);
+extern U32  rt_stk_used      (P_TCB p_TCB, U32 *size);
+#endif
 
 /*----------------------------------------------------------------------------
  * end of file
@@ -39,6 +39,10 @@
 #include "rt_List.h"
 #include "rt_MemBox.h"
 #include "rt_Robin.h"
+#include "rt_Trace.h"
+#include "rt_Wait.h"
+#include "rt_Edf.h"
+#include "rt_Time.h"
 #include "rt_HAL_CM.h"
 
 /*----------------------------------------------------------------------------
@@ -70,7 +74,7 @@ static OS_TID rt_get_TID (void) {
 
 /*--------------------------- rt_init_context -------------------------------*/
 
-static void rt_init_context (P_TCB p_TCB, U8 priority, FUNCP task_body) {
+static BOOL rt_init_context (P_TCB p_TCB, U8 priority, FUNCP task_body) {
   /* Initialize general part of the Task Control Block. */
   p_TCB->cb_type   = TCB;
   p_TCB->state     = READY;
@@ -86,12 +90,45 @@ static void rt_init_context (P_TCB p_TCB, U8 priority, FUNCP task_body) {
   p_TCB->events  = 0U;
   p_TCB->waits   = 0U;
   p_TCB->stack_frame = 0U;
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+  p_TCB->p_qlnk  = NULL;
+  p_TCB->rdy_lvl = 0U;
+#endif
+#ifdef CONFIG_RTX_CPU_STAT
+  p_TCB->cpu_cycles = 0U;
+  p_TCB->cpu_mark   = 0U;
+  p_TCB->cpu_load   = 0U;
+#endif
+#ifdef CONFIG_RTX_STK_WATERMARK
+  p_TCB->stk_free   = 0xFFFFU;    /* Not scanned yet                         */
+#endif
+#ifdef CONFIG_RTX_PSQ_COALESCE
+  p_TCB->isr_events = 0U;
+#endif
+#ifdef CONFIG_RTX_PREEMPT_THR
+  p_TCB->prio_thr   = 0U;
+#endif
+#ifdef CONFIG_RTX_ROBIN_SLICE
+  p_TCB->slice      = 0U;
+#endif
+#ifdef CONFIG_RTX_EDF
+  p_TCB->edf_period = 0U;
+  p_TCB->edf_miss   = 0U;
+#endif
+#ifdef CONFIG_RTX_FAST_SYNC
+  p_TCB->p_mfast    = NULL;
+#endif
 
   if (p_TCB->priv_stack == 0U) {
     /* Allocate the memory space for the stack. */
     p_TCB->stack = rt_alloc_box (mp_stk);
+    if (p_TCB->stack == NULL) {
+      /* More tasks with the default stack than planned for */
+      return (__FALSE);
+    }
   }
   rt_init_stack (p_TCB, task_body);
+  return (__TRUE);
 }
 
 
@@ -99,6 +136,22 @@ static void rt_init_context (P_TCB p_TCB, U8 priority, FUNCP task_body) {
 
 void rt_switch_req (P_TCB p_next) {
   /* Switch to next task (identified by "p_next"). */
+#ifdef CONFIG_RTX_CPU_STAT
+  rt_cpu_switch ();
+#endif
+#ifdef CONFIG_RTX_TRACE
+  if (p_next != os_tsk.run) {
+    /* No running task after it deleted itself */
+    rt_trc_put (OS_TRC_SWITCH, p_next->task_id,
+                (os_tsk.run != NULL) ? os_tsk.run->task_id : 0U);
+  }
+#endif
+#ifdef CONFIG_RTX_PREEMPT_THR
+  if (p_next->prio < p_next->prio_thr) {
+    /* Runs at its preemption threshold until it blocks */
+    p_next->prio = p_next->prio_thr;
+  }
+#endif
   os_tsk.next = p_next;
   p_next->state = RUNNING;
   DBG_TASK_SWITCH(p_next->task_id);
@@ -117,8 +170,14 @@ void rt_dispatch (P_TCB next_TCB) {
   }
   else {
     /* Check which task continues */
+#ifdef CONFIG_RTX_EDF
+    if ((next_TCB->prio > os_tsk.run->prio) ||
+        ((next_TCB->prio == os_tsk.run->prio) && rt_edf_before (next_TCB, os_tsk.run))) {
+#else
     if (next_TCB->prio > os_tsk.run->prio) {
+#endif
       /* preempt running task */
+      TRC_EVENT(OS_TRC_READY, next_TCB->task_id, os_tsk.run->task_id);
       rt_put_rdy_first (os_tsk.run);
       os_tsk.run->state = READY;
       rt_switch_req (next_TCB);
@@ -132,19 +191,46 @@ void rt_dispatch (P_TCB next_TCB) {
 }
 
 
+/*--------------------------- rt_thr_drop -----------------------------------*/
+
+#ifdef CONFIG_RTX_PREEMPT_THR
+static void rt_thr_drop (P_TCB p_task) {
+  /* A task running at its preemption threshold blocks: it waits with its   */
+  /* base priority or the one inherited from tasks waiting for its mutexes. */
+  P_MUCB p_mlnk;
+  U8     prio = p_task->prio_base;
+
+  for (p_mlnk = p_task->p_mlnk; p_mlnk != NULL; p_mlnk = p_mlnk->p_mlnk) {
+    if ((p_mlnk->p_lnk != NULL) && (p_mlnk->p_lnk->prio > prio)) {
+      prio = p_mlnk->p_lnk->prio;
+    }
+  }
+  if (p_task->prio != prio) {
+    p_task->prio = prio;
+    /* It may already be queued on the object it waits for */
+    rt_resort_prio (p_task);
+  }
+}
+#endif
+
+
 /*--------------------------- rt_block --------------------------------------*/
 
-void rt_block (U16 timeout, U8 block_state) {
+void rt_block (U32 timeout, U8 block_state) {
   /* Block running task and choose next ready task.                         */
-  /* "timeout" sets a time-out value or is 0xffff (=no time-out).           */
+  /* "timeout" sets a time-out value or is 0xffffffff (=no time-out).       */
   /* "block_state" defines the appropriate task state */
   P_TCB next_TCB;
 
   if (timeout) {
-    if (timeout < 0xFFFFU) {
+    if (timeout < 0xFFFFFFFFU) {
       rt_put_dly (os_tsk.run, timeout);
     }
     os_tsk.run->state = block_state;
+    TRC_EVENT(OS_TRC_BLOCK, os_tsk.run->task_id, block_state);
+#ifdef CONFIG_RTX_PREEMPT_THR
+    rt_thr_drop (os_tsk.run);
+#endif
     next_TCB = rt_get_first (&os_rdy);
     rt_switch_req (next_TCB);
   }
@@ -187,7 +273,15 @@ OS_RESULT rt_tsk_prio (OS_TID task_id, U8 new_prio) {
     /* Change execution priority of calling task. */
     os_tsk.run->prio      = new_prio;
     os_tsk.run->prio_base = new_prio;
-run:if (rt_rdy_prio() > new_prio) {
+run:
+#ifdef CONFIG_RTX_PREEMPT_THR
+    if (new_prio < os_tsk.run->prio_thr) {
+      /* Keeps running at its preemption threshold */
+      new_prio = os_tsk.run->prio_thr;
+      os_tsk.run->prio = new_prio;
+    }
+#endif
+    if (rt_rdy_prio() > new_prio) {
       rt_put_prio (&os_rdy, os_tsk.run);
       os_tsk.run->state   = READY;
       rt_dispatch (NULL);
@@ -216,6 +310,22 @@ run:if (rt_rdy_prio() > new_prio) {
 }
 
 
+/*--------------------------- rt_tsk_thr ------------------------------------*/
+
+#ifdef CONFIG_RTX_PREEMPT_THR
+void rt_tsk_thr (P_TCB p_task, U8 thr) {
+  /* Set the preemption threshold of a task: while it runs, only tasks with */
+  /* a priority above "thr" preempt it. 0 or a value not above its priority */
+  /* turns it off. A lower threshold takes effect when the task blocks.     */
+  p_task->prio_thr = thr;
+  if ((p_task->state == RUNNING) && (p_task->prio < thr)) {
+    /* Already picked to run */
+    p_task->prio = thr;
+  }
+}
+#endif
+
+
 /*--------------------------- rt_tsk_create ---------------------------------*/
 
 OS_TID rt_tsk_create (FUNCP task, U32 prio_stksz, void *stk, void *argv) {
@@ -237,7 +347,10 @@ OS_TID rt_tsk_create (FUNCP task, U32 prio_stksz, void *stk, void *argv) {
   /* Pass parameter 'argv' to 'rt_init_context' */
   task_context->msg = argv;
   /* For 'size == 0' system allocates the user stack from the memory pool. */
-  rt_init_context (task_context, (U8)(prio_stksz & 0xFFU), task);
+  if (rt_init_context (task_context, (U8)(prio_stksz & 0xFFU), task) == __FALSE) {
+    rt_free_box (mp_tcb, task_context);
+    return (0U);
+  }
 
   /* Find a free entry in 'os_active_TCB' table. */
   i = rt_get_TID ();
@@ -246,12 +359,42 @@ OS_TID rt_tsk_create (FUNCP task, U32 prio_stksz, void *stk, void *argv) {
   }
   os_active_TCB[i-1U] = task_context;
   task_context->task_id = (U8)i;
+#ifdef CONFIG_RTX_STK_WATERMARK
+  if (os_stkw.idx == (i-1U)) {
+    /* Restart the scan of a slot that changed hands */
+    os_stkw.pos = 0U;
+  }
+#endif
   DBG_TASK_NOTIFY(task_context, __TRUE);
   rt_dispatch (task_context);
   return ((OS_TID)i);
 }
 
 
+#ifdef CONFIG_RTX_FAST_SYNC
+/*--------------------------- rt_mut_fast_adopt -----------------------------*/
+
+static void rt_mut_fast_adopt (P_TCB p_task) {
+  /* A task preempted in the mutex fast path may own the mutex it takes      */
+  /* or gives back without having it on its owner list. Link it there,       */
+  /* so it is released with the other mutexes of the task.                   */
+  P_MUCB p_MCB,p_mlnk;
+
+  p_MCB = p_task->p_mfast;
+  if ((p_MCB == NULL) || (p_MCB->owner != p_task)) {
+    return;
+  }
+  for (p_mlnk = p_task->p_mlnk; p_mlnk != NULL; p_mlnk = p_mlnk->p_mlnk) {
+    if (p_mlnk == p_MCB) {
+      return;
+    }
+  }
+  p_MCB->p_mlnk  = p_task->p_mlnk;
+  p_task->p_mlnk = p_MCB;
+}
+#endif
+
+
 /*--------------------------- rt_tsk_delete ---------------------------------*/
 
 OS_RESULT rt_tsk_delete (OS_TID task_id) {
@@ -313,6 +456,14 @@ OS_RESULT rt_tsk_delete (OS_TID task_id) {
     task_context = os_active_TCB[task_id-1U];
     rt_rmv_list (task_context);
     rt_rmv_dly (task_context);
+#ifdef CONFIG_RTX_WAIT_ANY
+    if (task_context->state == WAIT_ANY) {
+      rt_wait_cancel (task_context);
+    }
+#endif
+#ifdef CONFIG_RTX_FAST_SYNC
+    rt_mut_fast_adopt (task_context);
+#endif
     p_MCB = task_context->p_mlnk;
     while (p_MCB) {
       /* Release mutexes owned by this task */
@@ -387,11 +538,17 @@ void rt_sys_init (FUNCP first_task, U32 prio_stksz, void *stk) {
   /* Set up ready list: initially empty */
   os_rdy.cb_type = HCB;
   os_rdy.p_lnk   = NULL;
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+  rt_rdyq_init ();
+#endif
   /* Set up delay list: initially empty */
   os_dly.cb_type = HCB;
   os_dly.p_dlnk  = NULL;
   os_dly.p_blnk  = NULL;
   os_dly.delta_time = 0U;
+#ifdef CONFIG_RTX_DLY_WHEEL
+  rt_dlyw_init ();
+#endif
 
   /* Fix SP and system variables to assume idle task is running */
   /* Transform main program into idle task by assuming idle TCB */
@@ -400,11 +557,27 @@ void rt_sys_init (FUNCP first_task, U32 prio_stksz, void *stk) {
 #endif
   os_tsk.run = &os_idle_TCB;
   os_tsk.run->state = RUNNING;
+#ifdef CONFIG_RTX_CPU_STAT
+  rt_cpu_init ();
+#endif
+#ifdef CONFIG_RTX_CLOCK64
+  rt_clk_init ();
+#endif
+#ifdef CONFIG_RTX_STK_WATERMARK
+  rt_stk_init ();
+#endif
+#ifdef CONFIG_RTX_TRACE
+  rt_trc_init ();
+#endif
 
   /* Initialize ps queue */
   os_psq->first = 0U;
   os_psq->last  = 0U;
   os_psq->size  = os_fifo_size;
+  os_psqs.posts  = 0U;
+  os_psqs.merged = 0U;
+  os_psqs.ovf    = 0U;
+  os_psqs.peak   = 0U;
 
   rt_init_robin ();
 
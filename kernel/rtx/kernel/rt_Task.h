@@ -45,6 +45,9 @@
 #define WAIT_SEM        7U
 #define WAIT_MBX        8U
 #define WAIT_MUT        9U
+#define WAIT_MBF        10U
+#define WAIT_ANY        11U
+#define WAIT_EGRP       12U
 
 /* Return codes */
 #define OS_R_TMO        0x01U
@@ -63,10 +66,13 @@ extern struct OS_TCB os_idle_TCB;
 /* Functions */
 extern void      rt_switch_req (P_TCB p_next);
 extern void      rt_dispatch   (P_TCB next_TCB);
-extern void      rt_block      (U16 timeout, U8 block_state);
+extern void      rt_block      (U32 timeout, U8 block_state);
 extern void      rt_tsk_pass   (void);
 extern OS_TID    rt_tsk_self   (void);
 extern OS_RESULT rt_tsk_prio   (OS_TID task_id, U8 new_prio);
+#ifdef CONFIG_RTX_PREEMPT_THR
+extern void      rt_tsk_thr    (P_TCB p_task, U8 thr);
+#endif
 extern OS_TID    rt_tsk_create (FUNCP task, U32 prio_stksz, void *stk, void *argv);
 extern OS_RESULT rt_tsk_delete (OS_TID task_id);
 #ifdef __CMSIS_RTOS
@@ -36,6 +36,7 @@
 #include "RTX_Config.h"
 #include "rt_Task.h"
 #include "rt_Time.h"
+#include "rt_HAL_CM.h"
 
 /*----------------------------------------------------------------------------
  *      Global Variables
@@ -44,6 +45,12 @@
 /* Free running system tick counter */
 U32 os_time;
 
+#ifdef CONFIG_RTX_CLOCK64
+/* 64-bit clock, double buffered: the tick updates the copy not in use     */
+static volatile struct OS_CLK os_clk[2];
+static volatile U32 os_clk_seq;
+#endif
+
 
 /*----------------------------------------------------------------------------
  *      Functions
@@ -60,7 +67,7 @@ U32 rt_time_get (void) {
 
 /*--------------------------- rt_dly_wait -----------------------------------*/
 
-void rt_dly_wait (U16 delay_time) {
+void rt_dly_wait (U32 delay_time) {
   /* Delay task by "delay_time" */
   rt_block (delay_time, WAIT_DLY);
 }
@@ -68,10 +75,10 @@ void rt_dly_wait (U16 delay_time) {
 
 /*--------------------------- rt_itv_set ------------------------------------*/
 
-void rt_itv_set (U16 interval_time) {
+void rt_itv_set (U32 interval_time) {
   /* Set interval length and define start of first interval */
   os_tsk.run->interval_time = interval_time;
-  os_tsk.run->delta_time = interval_time + (U16)os_time;
+  os_tsk.run->delta_time = interval_time + os_time;
 }
 
 
@@ -79,15 +86,64 @@ void rt_itv_set (U16 interval_time) {
 
 void rt_itv_wait (void) {
   /* Wait for interval end and define start of next one */
-  U16 delta;
+  U32 delta;
 
-  delta = os_tsk.run->delta_time - (U16)os_time;
+  delta = os_tsk.run->delta_time - os_time;
   os_tsk.run->delta_time += os_tsk.run->interval_time;
-  if ((delta & 0x8000U) == 0U) {
+  if ((delta & 0x80000000U) == 0U) {
     rt_block (delta, WAIT_ITV);
   }
 }
 
+#ifdef CONFIG_RTX_CLOCK64
+
+/*--------------------------- rt_clk_init -----------------------------------*/
+
+void rt_clk_init (void) {
+  /* Start the cycle counter, the 64-bit clock counts from now.            */
+  rt_cpu_start ();
+  os_clk[0].cnt  = rt_cpu_cycles ();
+  os_clk[0].time = 0U;
+  os_clk_seq     = 0U;
+}
+
+
+/*--------------------------- rt_clk_sync -----------------------------------*/
+
+void rt_clk_sync (void) {
+  /* Carry the cycle counter into the 64-bit clock. Called from the tick,  */
+  /* at least once per counter wrap. A reader that interrupts this one     */
+  /* uses the copy of "os_clk_seq", which is not written here.             */
+  U32 seq = os_clk_seq;
+  U32 cnt = rt_cpu_cycles ();
+
+  os_clk[(seq + 1U) & 1U].time = os_clk[seq & 1U].time + (U32)(cnt - os_clk[seq & 1U].cnt);
+  os_clk[(seq + 1U) & 1U].cnt  = cnt;
+  os_clk_seq = seq + 1U;
+}
+
+
+/*--------------------------- rt_clk_get ------------------------------------*/
+
+U64 rt_clk_get (void) {
+  /* Return the 64-bit clock in cycles. Lock-free, callable from any       */
+  /* context.                                                              */
+  /* The copy read is complete unless the tick updated the clock twice in  */
+  /* between; "os_clk_seq" has changed then and the read is repeated.      */
+  U32 seq,cnt;
+  U64 time;
+
+  do {
+    seq  = os_clk_seq;
+    time = os_clk[seq & 1U].time;
+    cnt  = os_clk[seq & 1U].cnt;
+    cnt  = rt_cpu_cycles () - cnt;
+  } while (seq != os_clk_seq);
+  return (time + cnt);
+}
+
+#endif
+
 /*----------------------------------------------------------------------------
  * end of file
  *---------------------------------------------------------------------------*/
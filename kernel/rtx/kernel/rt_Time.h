@@ -37,9 +37,14 @@ extern U32 os_time;
 
 /* Functions */
 extern U32  rt_time_get (void);
-extern void rt_dly_wait (U16 delay_time);
-extern void rt_itv_set  (U16 interval_time);
+extern void rt_dly_wait (U32 delay_time);
+extern void rt_itv_set  (U32 interval_time);
 extern void rt_itv_wait (void);
+#ifdef CONFIG_RTX_CLOCK64
+extern void rt_clk_init (void);
+extern void rt_clk_sync (void);
+extern U64  rt_clk_get  (void);
+#endif
 
 /*----------------------------------------------------------------------------
  * end of file
@@ -0,0 +1,130 @@
+/*----------------------------------------------------------------------------
+ *      CMSIS-RTOS  -  RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_TRACE.C
+ *      Purpose: Kernel event trace recorder
+ *      Rev.:    V4.79
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2015 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_Trace.h"
+#include "rt_HAL_CM.h"
+
+/*----------------------------------------------------------------------------
+ *      Global Variables
+ *---------------------------------------------------------------------------*/
+
+/* Trace ring buffer */
+struct OS_TRC os_trc;
+
+
+/*----------------------------------------------------------------------------
+ *      Global Functions
+ *---------------------------------------------------------------------------*/
+
+/*--------------------------- rt_trc_init -----------------------------------*/
+
+void rt_trc_init (void) {
+  /* Start the time stamp counter, the buffer is empty. */
+  os_trc.head = 0U;
+  os_trc.tail = 0U;
+  rt_cpu_start ();
+}
+
+
+/*--------------------------- rt_trc_put ------------------------------------*/
+
+void rt_trc_put (U32 event, U32 task, U32 arg) {
+  /* Record "event" of "task" with "arg". Called from any context: the slot */
+  /* is reserved with one atomic increment, and the 'info' word written    */
+  /* last marks the record complete for the reader.                        */
+  P_TREC p;
+  U32 idx;
+
+  idx = rt_fetch_inc (&os_trc.head);
+  p = &os_trc.rec[idx & (OS_TRC_SIZE-1U)];
+  p->time = rt_cpu_cycles ();
+  __DMB ();
+  p->info = OS_TRC_INFO (OS_TRC_LAP (idx), event, task, arg);
+}
+
+
+/*--------------------------- rt_trc_read -----------------------------------*/
+
+U32 rt_trc_read (P_TREC buf, U32 cnt) {
+  /* Move up to "cnt" records to "buf", oldest first, and return how many. */
+  /* Records overwritten before they were read are reported by a record of */
+  /* OS_TRC_LOST. There must be only one reader at a time.                 */
+  P_TREC p;
+  U32 head,tail,lost,info,time,n;
+
+  tail = os_trc.tail;
+  for (n = 0U; n < cnt; ) {
+    head = os_trc.head;
+    if ((head - tail) > OS_TRC_SIZE) {
+      /* Writers went round the ring, go on with the oldest record kept */
+      lost  = head - tail - OS_TRC_SIZE;
+      tail += lost;
+      if (lost > 0xFFFFU) {
+        lost = 0xFFFFU;
+      }
+      buf[n].time = 0U;
+      buf[n].info = OS_TRC_INFO (0U, OS_TRC_LOST, 0U, lost);
+      n++;
+      continue;
+    }
+    if (tail == head) {
+      break;
+    }
+    p = &os_trc.rec[tail & (OS_TRC_SIZE-1U)];
+    info = p->info;
+    if (((info >> 29) != OS_TRC_LAP (tail)) || (((info >> 24) & 0x1FU) == 0U)) {
+      /* Reserved, but not written yet */
+      break;
+    }
+    __DMB ();
+    time = p->time;
+    __DMB ();
+    if ((os_trc.head - tail) > OS_TRC_SIZE) {
+      /* Overwritten while being read */
+      continue;
+    }
+    buf[n].time = time;
+    buf[n].info = info;
+    n++;
+    tail++;
+  }
+  os_trc.tail = tail;
+  return (n);
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
@@ -0,0 +1,72 @@
+/*----------------------------------------------------------------------------
+ *      CMSIS-RTOS  -  RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_TRACE.H
+ *      Purpose: Kernel event trace recorder definitions
+ *      Rev.:    V4.79
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2015 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+/* Trace events, with the meaning of 'task' and 'arg' of their record */
+#define OS_TRC_SWITCH   1U        /* Task switched to, from (0: deleted)     */
+#define OS_TRC_BLOCK    2U        /* Running task blocks, its wait state     */
+#define OS_TRC_READY    3U        /* Task made ready, running task           */
+#define OS_TRC_TIMEOUT  4U        /* Task whose wait timed out, wait state   */
+#define OS_TRC_IRQ_IN   5U        /* -, exception number                     */
+#define OS_TRC_IRQ_OUT  6U        /* -, exception number                     */
+#define OS_TRC_POST     7U        /* Object type, task ID or object address  */
+#define OS_TRC_PRIO     8U        /* Task, old priority << 8 | new priority  */
+#define OS_TRC_LOST     9U        /* -, records overwritten before read      */
+
+/* Exception numbers of the kernel handlers */
+#define OS_TRC_PENDSV   14U
+#define OS_TRC_SYSTICK  15U
+
+/* Record 'info': lap of the ring (3 bits), event (5), task (8), arg (16). */
+/* The lap tells a record from the one it overwrites.                     */
+#define OS_TRC_LAP(idx)         (((idx) >> CONFIG_RTX_TRACE_BITS) & 7U)
+#define OS_TRC_INFO(lap,ev,task,arg) (((U32)(lap) << 29) | ((U32)(ev) << 24) | \
+                                      (((U32)(task) & 0xFFU) << 16) | ((U32)(arg) & 0xFFFFU))
+
+#ifdef CONFIG_RTX_TRACE
+/* Variables */
+extern struct OS_TRC os_trc;
+
+/* Functions */
+extern void rt_trc_init (void);
+extern void rt_trc_put  (U32 event, U32 task, U32 arg);
+extern U32  rt_trc_read (P_TREC buf, U32 cnt);
+
+#define TRC_EVENT(ev,task,arg)  rt_trc_put(ev,task,arg)
+#else
+#define TRC_EVENT(ev,task,arg)
+#endif
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
@@ -59,8 +59,8 @@ typedef struct OS_TCB {
   struct OS_TCB *p_rlnk;          /* Link pointer for sem./mbx lst backwards */
   struct OS_TCB *p_dlnk;          /* Link pointer for delay list             */
   struct OS_TCB *p_blnk;          /* Link pointer for delay list backwards   */
-  U16    delta_time;              /* Time until time out                     */
-  U16    interval_time;           /* Time interval for periodic waits        */
+  U32    delta_time;              /* Time until time out                     */
+  U32    interval_time;           /* Time interval for periodic waits        */
   U16    events;                  /* Event flags                             */
   U16    waits;                   /* Wait flags                              */
   void   **msg;                   /* Direct message passing when task waits  */
@@ -76,9 +76,49 @@ typedef struct OS_TCB {
 
   /* Task entry point used for uVision debugger                              */
   FUNCP  ptask;                   /* Task entry address                      */
+
+#ifdef CONFIG_RTX_RDYQ_BITMAP
+  /* Bitmap ready queue part                                                 */
+  struct OS_TCB *p_qlnk;          /* Link pointer for ready queue backwards  */
+  U8     rdy_lvl;                 /* Ready queue level the task is put in    */
+#endif
+#ifdef CONFIG_RTX_CPU_STAT
+  /* CPU usage accounting part                                               */
+  U32    cpu_cycles;              /* Cycles run, free running                */
+  U32    cpu_mark;                /* 'cpu_cycles' at start of load window    */
+  U32    cpu_load;                /* Cycles run in the last load window      */
+#endif
+#ifdef CONFIG_RTX_STK_WATERMARK
+  /* Stack watermark part                                                    */
+  U32    stk_free;                /* Stack words never used, at last scan    */
+#endif
+#ifdef CONFIG_RTX_PSQ_COALESCE
+  /* ISR post coalescing part                                                */
+  U16    isr_events;              /* Event flags set by ISRs, not yet posted */
+#endif
+#ifdef CONFIG_RTX_PREEMPT_THR
+  /* Preemption threshold part                                               */
+  U8     prio_thr;                /* Priority to run at, 0: 'prio'           */
+#endif
+#ifdef CONFIG_RTX_ROBIN_SLICE
+  /* Round Robin part                                                        */
+  U16    slice;                   /* Time slice in ticks, 0: OS_ROBINTOUT    */
+#endif
+#ifdef CONFIG_RTX_EDF
+  /* Earliest deadline first part                                            */
+  U32    edf_dl;                  /* Absolute deadline of the current job    */
+  U32    edf_rel;                 /* Release time of the current job         */
+  U32    edf_period;              /* Period in ticks, 0: not an EDF task     */
+  U32    edf_dline;               /* Relative deadline in ticks              */
+  U32    edf_miss;                /* Jobs that ended after their deadline    */
+#endif
+#ifdef CONFIG_RTX_FAST_SYNC
+  /* Mutex fast path part                                                    */
+  struct OS_MUCB *p_mfast;        /* Mutex being taken or given back         */
+#endif
 } *P_TCB;
-#define TCB_STACKF      37        /* 'stack_frame' offset                    */
-#define TCB_TSTACK      40        /* 'tsk_stack' offset                      */
+#define TCB_STACKF      41        /* 'stack_frame' offset                    */
+#define TCB_TSTACK      44        /* 'tsk_stack' offset                      */
 
 typedef struct OS_PSFE {          /* Post Service Fifo Entry                 */
   void  *id;                      /* Object Identification                   */
@@ -86,13 +126,37 @@ typedef struct OS_PSFE {          /* Post Service Fifo Entry                 */
 } *P_PSFE;
 
 typedef struct OS_PSQ {           /* Post Service Queue                      */
-  U8     first;                   /* FIFO Head Index                         */
-  U8     last;                    /* FIFO Tail Index                         */
-  U8     count;                   /* Number of stored items in FIFO          */
-  U8     size;                    /* FIFO Size                               */
+  U16    first;                   /* FIFO Head Index                         */
+  U16    last;                    /* FIFO Tail Index                         */
+  U16    count;                   /* Number of stored items in FIFO          */
+  U16    size;                    /* FIFO Size                               */
   struct OS_PSFE q[1];            /* FIFO Content                            */
 } *P_PSQ;
 
+typedef struct OS_PSQS {          /* Post Service Queue statistics           */
+  U32    posts;                   /* Posts from ISRs, free running           */
+  U32    merged;                  /* Posts merged into a pending entry       */
+  U32    ovf;                     /* Posts lost to a full FIFO               */
+  U32    peak;                    /* Highest number of stored items          */
+} *P_PSQS;
+
+#define OS_RDYQ_LVLS    32U       /* Number of bitmap ready queue levels     */
+
+typedef struct OS_RDYQ {          /* Bitmap indexed ready queue              */
+  U32    map;                     /* Bitmap of non-empty priority levels     */
+  struct OS_TCB *first[OS_RDYQ_LVLS]; /* Head of ready FIFO per level        */
+  struct OS_TCB *last[OS_RDYQ_LVLS];  /* Tail of ready FIFO per level        */
+} *P_RDYQ;
+
+#ifdef CONFIG_RTX_DLY_WHEEL
+#define OS_DLYW_SLOTS   (1U << CONFIG_RTX_DLY_WHEEL_BITS)
+
+typedef struct OS_DLYW {          /* Hashed timing wheel for delays          */
+  U32    cnt;                     /* Number of tasks in the wheel            */
+  struct OS_TCB *slot[OS_DLYW_SLOTS]; /* Chain of tasks hashed to slot       */
+} *P_DLYW;
+#endif
+
 typedef struct OS_TSK {
   P_TCB  run;                     /* Current running task                    */
   P_TCB  next;                    /* Scheduled task to run                   */
@@ -102,15 +166,73 @@ typedef struct OS_ROBIN {         /* Round Robin Control                     */
   P_TCB  task;                    /* Round Robin task                        */
   U16    time;                    /* Round Robin switch time                 */
   U16    tout;                    /* Round Robin timeout                     */
+#ifdef CONFIG_RTX_ROBIN_SLICE
+  U32    off;                     /* Priorities 0..31 with Round Robin off   */
+#endif
 } *P_ROBIN;
 
+#ifdef CONFIG_RTX_STK_WATERMARK
+#define OS_STKW_CHUNK   32U       /* Stack words scanned per idle step       */
+
+typedef struct OS_STKW {          /* Stack watermark scan                    */
+  U16    idx;                     /* Stack scanned: task, idle, MSP          */
+  U16    pos;                     /* Next word to check in that stack        */
+  U32    msp_free;                /* MSP words never used, at last scan      */
+} *P_STKW;
+#endif
+
+#ifdef CONFIG_RTX_STK_POOLS
+#define OS_STKCLS_NUM   4U        /* Number of stack size classes            */
+
+typedef struct OS_STKCLS {        /* Stack size class pool use               */
+  U16    used;                    /* Blocks in use                           */
+  U16    peak;                    /* Highest number of blocks in use         */
+  U32    miss;                    /* Requests that found the class used up   */
+} *P_STKCLS;
+#endif
+
+#ifdef CONFIG_RTX_TRACE
+#define OS_TRC_SIZE     (1U << CONFIG_RTX_TRACE_BITS)
+
+typedef struct OS_TREC {          /* Trace record                            */
+  U32    time;                    /* Cycle count when recorded               */
+  U32    info;                    /* Lap, event, task and argument           */
+} *P_TREC;
+
+typedef struct OS_TRC {           /* Trace ring buffer                       */
+  U32    head;                    /* Records reserved, free running          */
+  U32    tail;                    /* Records read, free running              */
+  struct OS_TREC rec[OS_TRC_SIZE]; /* Ring of records                        */
+} *P_TRC;
+#endif
+
+#ifdef CONFIG_RTX_CPU_STAT
+typedef struct OS_CPU {           /* CPU usage accounting                    */
+  U32    stamp;                   /* Cycle count at the last charge          */
+  U32    nest;                    /* Interrupt nesting level                 */
+  U32    irq_cycles;              /* Cycles in interrupts, free running      */
+  U32    irq_mark;                /* 'irq_cycles' at start of load window    */
+  U32    irq_load;                /* Cycles in interrupts in the last window */
+  U32    win_start;               /* Cycle count at start of load window     */
+  U32    win_len;                 /* Cycles in the last load window          */
+  U32    win_time;                /* 'os_time' at start of load window       */
+} *P_CPU;
+#endif
+
+#ifdef CONFIG_RTX_CLOCK64
+typedef struct OS_CLK {           /* 64-bit clock at a cycle counter value   */
+  U32    cnt;                     /* Cycle counter at the last update        */
+  U64    time;                    /* Cycles since rt_clk_init() at 'cnt'     */
+} *P_CLK;
+#endif
+
 typedef struct OS_XCB {
   U8     cb_type;                 /* Control Block Type                      */
   struct OS_TCB *p_lnk;           /* Link pointer for ready/sem. wait list   */
   struct OS_TCB *p_rlnk;          /* Link pointer for sem./mbx lst backwards */
   struct OS_TCB *p_dlnk;          /* Link pointer for delay list             */
   struct OS_TCB *p_blnk;          /* Link pointer for delay list backwards   */
-  U16    delta_time;              /* Time until time out                     */
+  U32    delta_time;              /* Time until time out                     */
 } *P_XCB;
 
 typedef struct OS_MCB {
@@ -130,6 +252,9 @@ typedef struct OS_SCB {
   U8     mask;                    /* Semaphore token mask                    */
   U16    tokens;                  /* Semaphore tokens                        */
   struct OS_TCB *p_lnk;           /* Chain of tasks waiting for tokens       */
+#ifdef CONFIG_RTX_PSQ_COALESCE
+  U16    isr_tokens;              /* Tokens sent by ISRs, not yet posted     */
+#endif
 } *P_SCB;
 
 typedef struct OS_MUCB {
@@ -140,6 +265,61 @@ typedef struct OS_MUCB {
   struct OS_MUCB *p_mlnk;         /* Chain of mutexes by owner task          */
 } *P_MUCB;
 
+#ifdef CONFIG_RTX_MSGBUF
+typedef struct OS_MBF {
+  U8     cb_type;                 /* Control Block Type                      */
+  volatile U8 state;              /* Reader waits, or is about to            */
+  struct OS_TCB *p_lnk;           /* Task waiting for data                   */
+  U32    size;                    /* Size of the data area in bytes          */
+  /* Writer side                                                             */
+  volatile U32 head;              /* Offset of the next record to commit     */
+  U32    resv;                    /* Offset of the reserved record           */
+  U32    resv_len;                /* Length of the reserved record           */
+  volatile U32 bytes_in;          /* Bytes committed, free running           */
+  volatile U32 recs_in;           /* Records committed, free running         */
+  /* Reader side                                                             */
+  volatile U32 tail;              /* Offset of the oldest record             */
+  volatile U32 bytes_out;         /* Bytes released, free running            */
+  volatile U32 recs_out;          /* Records released, free running          */
+  U32    wait_bytes;              /* Bytes the reader waits for, 0: any      */
+  U32    wait_recs;               /* Records the reader waits for, 0: any    */
+  U32    data[1];                 /* Records: length word, data, padding     */
+} *P_MBF;
+#endif
+
+#ifdef CONFIG_RTX_EVT_GROUP
+typedef struct OS_EGRP {
+  U8     cb_type;                 /* Control Block Type                      */
+  struct OS_TCB *p_lnk;           /* Chain of tasks waiting for flags        */
+  volatile U32 flags;             /* Event flags                             */
+} *P_EGRP;
+#endif
+
+#ifdef CONFIG_RTX_WAIT_ANY
+#define OS_WAIT_MAX     8U        /* Objects of one multi-object wait        */
+
+typedef struct OS_WNODE {         /* Task queued on one object of a wait     */
+  U8     cb_type;                 /* Control Block Type (WCB)                */
+  U8     idx;                     /* Index of the object in the wait         */
+  U8     prio;                    /* Priority of the waiting task            */
+  U8     reserved;
+  struct OS_TCB *p_lnk;           /* Link pointer for object wait list       */
+  struct OS_TCB *p_rlnk;          /* Link pointer for object list backwards  */
+  struct OS_WAIT *p_wait;         /* Wait the node belongs to                */
+  void   *obj;                    /* Semaphore or mailbox waited for         */
+} *P_WNODE;
+
+typedef struct OS_WAIT {          /* Multi-object wait, on the task's stack  */
+  struct OS_TCB *task;            /* Waiting task                            */
+  U16    cnt;                     /* Number of objects                       */
+  U16    signals;                 /* Event flags waited for, 0: none         */
+  S32    idx;                     /* Object that fired, 'cnt': event flags,  */
+                                  /* -1: none                                */
+  U32    val;                     /* Message, tokens or event flags received */
+  struct OS_WNODE node[OS_WAIT_MAX];
+} *P_WAIT;
+#endif
+
 typedef struct OS_XTMR {
   struct OS_TMR  *next;
   U16    tcnt;
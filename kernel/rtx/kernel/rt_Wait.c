@@ -0,0 +1,207 @@
+/*----------------------------------------------------------------------------
+ *      CMSIS-RTOS  -  RTX
+ *----------------------------------------------------------------------------
+ *      Name:    RT_WAIT.C
+ *      Purpose: Wait for any of several objects
+ *      Rev.:    V4.79
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 1999-2009 KEIL, 2009-2015 ARM Germany GmbH
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used 
+ *    to endorse or promote products derived from this software without 
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" 
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE 
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF 
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS 
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN 
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) 
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_System.h"
+#include "rt_List.h"
+#include "rt_Task.h"
+#include "rt_Semaphore.h"
+#include "rt_Mailbox.h"
+#include "rt_Wait.h"
+#include "rt_HAL_CM.h"
+
+/*----------------------------------------------------------------------------
+ *      A task waiting for several objects is queued on each of them by a
+ *      wait node. A node starts like a TCB up to 'p_rlnk', so it is put
+ *      into and taken off the wait list of a semaphore or mailbox like a
+ *      task waiting for that object alone. The object that wakes a node
+ *      passes it to rt_wait_take(), which records what fired in the wait
+ *      and takes the other nodes out before the task is made ready. The
+ *      nodes live in the OS_WAIT on the stack of the waiting task, 'msg'
+ *      of the task points to it while it is in WAIT_ANY state.
+ *---------------------------------------------------------------------------*/
+
+
+/*----------------------------------------------------------------------------
+ *      Functions
+ *---------------------------------------------------------------------------*/
+
+
+/*--------------------------- rt_wait_any -----------------------------------*/
+
+S32 rt_wait_any (P_WAIT p_wait, U32 timeout) {
+  /* Take from the first object of "p_wait" that has a token or message,    */
+  /* or take the event flags waited for; otherwise queue the running task   */
+  /* on all objects and block it. Returns the index of what fired or -1,    */
+  /* a task woken later finds the result in "p_wait".                       */
+  P_TCB   p_task = os_tsk.run;
+  P_WNODE p_node;
+  P_XCB   p_CB;
+  void   *msg;
+  U32     i;
+
+  p_wait->task = p_task;
+  p_wait->idx  = -1;
+  p_wait->val  = 0U;
+  for (i = 0U; i < p_wait->cnt; i++) {
+    p_CB = p_wait->node[i].obj;
+    if (p_CB->cb_type == SCB) {
+      if (rt_sem_wait (p_CB, 0U) == OS_R_OK) {
+        p_wait->val = 1U;
+        p_wait->idx = (S32)i;
+        return (p_wait->idx);
+      }
+    }
+    else if (rt_mbx_wait (p_CB, &msg, 0U) == OS_R_OK) {
+      p_wait->val = (U32)msg;
+      p_wait->idx = (S32)i;
+      return (p_wait->idx);
+    }
+  }
+  if (p_task->events & p_wait->signals) {
+    p_wait->val     = p_task->events & p_wait->signals;
+    p_task->events &= ~p_wait->val;
+    p_wait->idx     = (S32)p_wait->cnt;
+    return (p_wait->idx);
+  }
+  if (timeout == 0U) {
+    return (-1);
+  }
+
+  /* Nothing there: wait for all of it */
+  for (i = 0U; i < p_wait->cnt; i++) {
+    p_node = &p_wait->node[i];
+    p_CB   = p_node->obj;
+    p_node->cb_type = WCB;
+    p_node->idx     = (U8)i;
+    p_node->prio    = p_task->prio;
+    p_node->p_wait  = p_wait;
+    p_node->p_rlnk  = NULL;
+    if (p_CB->p_lnk == NULL) {
+      p_CB->p_lnk    = (P_TCB)p_node;
+      p_node->p_lnk  = NULL;
+      p_node->p_rlnk = (P_TCB)p_CB;
+      if (p_CB->cb_type == MCB) {
+        /* Task is waiting to receive a message */
+        ((P_MCB)p_CB)->state = 1U;
+      }
+    }
+    else if ((p_CB->cb_type == SCB) || (((P_MCB)p_CB)->state == 1U)) {
+      rt_put_prio (p_CB, (P_TCB)p_node);
+    }
+    /* Else tasks wait to allocate mail from the queue: it is not watched */
+  }
+  p_task->waits = p_wait->signals;
+  p_task->msg   = (void **)p_wait;
+  rt_block (timeout, WAIT_ANY);
+  return (-1);
+}
+
+
+/*--------------------------- rt_wait_take ----------------------------------*/
+
+P_TCB rt_wait_take (P_TCB p_TCB, U32 val) {
+  /* "p_TCB" was taken off the wait list of an object that passes "val" to  */
+  /* it. A task is returned as it is; for the node of a multi-object wait   */
+  /* the object and "val" are recorded, the other nodes are taken out and   */
+  /* the waiting task is returned.                                          */
+  P_WAIT p_wait;
+
+  if (p_TCB->cb_type != WCB) {
+    return (p_TCB);
+  }
+  p_wait = ((P_WNODE)p_TCB)->p_wait;
+  p_wait->idx = ((P_WNODE)p_TCB)->idx;
+  p_wait->val = val;
+  rt_wait_cancel (p_wait->task);
+  return (p_wait->task);
+}
+
+
+/*--------------------------- rt_wait_sig -----------------------------------*/
+
+void rt_wait_sig (P_TCB p_task) {
+  /* Event flags "p_task" waits for in WAIT_ANY state were set: end the     */
+  /* wait with them. The caller puts the task into the ready list.          */
+  P_WAIT p_wait = (P_WAIT)p_task->msg;
+
+  p_wait->val     = p_task->events & p_wait->signals;
+  p_task->events &= ~p_wait->val;
+  p_wait->idx     = (S32)p_wait->cnt;
+  rt_wait_cancel (p_task);
+  rt_rmv_dly (p_task);
+  p_task->state   = READY;
+}
+
+
+/*--------------------------- rt_wait_cancel --------------------------------*/
+
+void rt_wait_cancel (P_TCB p_task) {
+  /* Take the nodes of "p_task" out of the object wait lists. */
+  P_WAIT  p_wait = (P_WAIT)p_task->msg;
+  P_WNODE p_node;
+  U32     i;
+
+  for (i = 0U; i < p_wait->cnt; i++) {
+    p_node = &p_wait->node[i];
+    if (p_node->p_rlnk != NULL) {
+      rt_rmv_list ((P_TCB)p_node);
+      p_node->p_rlnk = NULL;
+    }
+  }
+}
+
+
+/*--------------------------- rt_wait_resort --------------------------------*/
+
+void rt_wait_resort (P_TCB p_task) {
+  /* Re-sort the nodes of "p_task" after its priority has changed. */
+  P_WAIT  p_wait = (P_WAIT)p_task->msg;
+  P_WNODE p_node;
+  U32     i;
+
+  for (i = 0U; i < p_wait->cnt; i++) {
+    p_node = &p_wait->node[i];
+    p_node->prio = p_task->prio;
+    if (p_node->p_rlnk != NULL) {
+      rt_rmv_list ((P_TCB)p_node);
+      rt_put_prio ((P_XCB)p_node->obj, (P_TCB)p_node);
+    }
+  }
+}
+
+/*----------------------------------------------------------------------------
+ * end of file
+ *---------------------------------------------------------------------------*/
@@ -0,0 +1,289 @@
+#!/usr/bin/env python3
+"""
+Convert an RTX kernel event trace (CONFIG_RTX_TRACE) into Chrome trace
+event JSON, to be opened in https://ui.perfetto.dev or chrome://tracing.
+
+The input is either the raw bytes of os_trace_header() followed by
+os_trace_read(), or a console log with the trace= lines printed by
+app/benchmark/rtx. When a log holds several dumps the last one is used.
+
+    scripts/rtx_trace.py console.log -o trace.json --name 1=main
+
+Every task gets a track showing when it runs, waits and is ready, and
+interrupts get a track of their own. Flow arrows lead from the context
+that woke a task to the moment it runs, so wake up latency chains can be
+followed through interrupts, posts and switches.
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+MAGIC = 0x54585452
+VERSION = 1
+
+EV_SWITCH, EV_BLOCK, EV_READY, EV_TIMEOUT, EV_IRQ_IN, EV_IRQ_OUT, \
+    EV_POST, EV_PRIO, EV_LOST = range(1, 10)
+
+WAIT_STATES = {
+    3: "delay", 4: "interval", 5: "event (or)", 6: "event (and)",
+    7: "semaphore", 8: "mailbox", 9: "mutex", 10: "message buffer",
+    11: "any object", 12: "event group",
+}
+
+POST_TYPES = {0: "signal", 1: "mailbox", 2: "semaphore", 5: "message buffer",
+              7: "event group"}
+
+IDLE = 255
+IRQ_TID = 0
+PID = 1
+
+
+def parse_words(data):
+    """Return the 32-bit words of the last dump in raw or log form."""
+    if data[:4] == struct.pack("<I", MAGIC):
+        n = len(data) // 4
+        return list(struct.unpack("<%dI" % n, data[:n * 4]))
+
+    words = []
+    for line in data.decode("ascii", "replace").splitlines():
+        m = re.search(r"trace=([0-9a-fA-F,]+)", line)
+        if not m:
+            continue
+        line_words = [int(w, 16) for w in m.group(1).split(",") if w]
+        if line_words and line_words[0] == MAGIC:
+            words = []
+        words.extend(line_words)
+    return words
+
+
+def decode(words):
+    """Check the header and return (clock in Hz, records)."""
+    if len(words) < 4 or words[0] != MAGIC:
+        sys.exit("rtx_trace: no trace header found")
+    if words[1] & 0xFFFF != VERSION or words[1] >> 16 != 8:
+        sys.exit("rtx_trace: unsupported trace version %#x" % words[1])
+    freq = words[2]
+
+    records = []
+    for i in range(4, len(words) - 1, 2):
+        time, info = words[i], words[i + 1]
+        records.append((time, (info >> 24) & 0x1F, (info >> 16) & 0xFF,
+                        info & 0xFFFF))
+    return freq, records
+
+
+def unwrap(records):
+    """Turn the 32-bit time stamps into a monotonic count from the first.
+
+    A record is stamped after its slot is taken, so a writer that gets
+    interrupted may stamp later than the next one; deltas are signed.
+    """
+    out = []
+    last = None
+    now = 0
+    for seq, (time, event, task, arg) in enumerate(records):
+        if event != EV_LOST:
+            if last is not None:
+                delta = (time - last) & 0xFFFFFFFF
+                if delta & 0x80000000:
+                    delta -= 1 << 32
+                now += delta
+            last = time
+        out.append((now, seq, event, task, arg))
+    out.sort()
+    return out
+
+
+def exc_name(num):
+    if num == 14:
+        return "PendSV"
+    if num == 15:
+        return "SysTick"
+    if num >= 16:
+        return "IRQ %d" % (num - 16)
+    return "exception %d" % num
+
+
+class Converter:
+    def __init__(self, freq, names):
+        self.freq = freq
+        self.names = names
+        self.events = []
+        self.tasks = set()
+        self.running = None
+        self.run_start = {}
+        self.blocked = {}
+        self.ready = {}
+        self.flows = {}
+        self.flow_id = 0
+        self.irqs = []
+
+    def us(self, cycles):
+        return cycles * 1e6 / self.freq
+
+    def name(self, task):
+        if task in self.names:
+            return self.names[task]
+        if task == IDLE:
+            return "idle"
+        return "task %d" % task
+
+    def emit(self, ph, tid, ts, **kw):
+        ev = {"ph": ph, "pid": PID, "tid": tid, "ts": self.us(ts)}
+        ev.update(kw)
+        self.events.append(ev)
+
+    def span(self, tid, start, end, name, cat, args=None):
+        self.emit("X", tid, start, dur=self.us(end) - self.us(start),
+                  name=name, cat=cat, args=args or {})
+
+    def context(self):
+        """Track of the code running now: an interrupt or a task."""
+        if self.irqs or self.running is None:
+            return IRQ_TID
+        return self.running
+
+    def switch(self, now, task, prev):
+        if prev == 0:
+            # The running task deleted itself
+            prev = self.running
+        if self.running is None:
+            self.run_start[prev] = self.start
+        if prev in self.run_start:
+            self.span(prev, self.run_start.pop(prev), now, self.name(prev),
+                      "run")
+        if task in self.ready:
+            start = self.ready.pop(task)
+            self.span(task, start, now, "ready", "sched",
+                      {"latency_us": self.us(now) - self.us(start)})
+        if task in self.flows:
+            self.emit("f", task, now, name="wake", cat="wake",
+                      id=self.flows.pop(task), bp="e")
+        self.run_start[task] = now
+        self.running = task
+
+    def wake(self, now, task, waker):
+        if task in self.blocked:
+            start, state, timeout = self.blocked.pop(task)
+            name = "wait " + WAIT_STATES.get(state, str(state))
+            if timeout:
+                name += " (timeout)"
+            self.span(task, start, now, name, "wait")
+        elif task in self.tasks or task == self.running:
+            # Put back after a priority change, already ready
+            return
+        self.ready[task] = now
+        self.flow_id += 1
+        self.flows[task] = self.flow_id
+        src = IRQ_TID if self.irqs else waker
+        self.emit("s", src, now, name="wake", cat="wake", id=self.flow_id)
+
+    def run(self, records):
+        if not records:
+            return
+        self.start = records[0][0]
+        end = records[-1][0]
+        for now, _, event, task, arg in records:
+            if event == EV_SWITCH:
+                self.switch(now, task, arg)
+            elif event == EV_BLOCK:
+                self.blocked[task] = [now, arg, False]
+            elif event == EV_TIMEOUT:
+                if task in self.blocked:
+                    self.blocked[task][2] = True
+            elif event == EV_READY:
+                self.wake(now, task, arg)
+            elif event == EV_IRQ_IN:
+                self.irqs.append(arg)
+                self.emit("B", IRQ_TID, now, name=exc_name(arg), cat="irq")
+            elif event == EV_IRQ_OUT:
+                if self.irqs:
+                    self.irqs.pop()
+                    self.emit("E", IRQ_TID, now)
+            elif event == EV_POST:
+                if task == 0:
+                    args = {"task": self.name(arg)}
+                else:
+                    args = {"object": "%#x" % (arg << 2)}
+                self.emit("i", self.context(), now, s="t", cat="post",
+                          name="post " + POST_TYPES.get(task, str(task)),
+                          args=args)
+            elif event == EV_PRIO:
+                self.emit("i", task, now, s="t", cat="prio",
+                          name="prio %d -> %d" % (arg >> 8, arg & 0xFF))
+            elif event == EV_LOST:
+                self.emit("i", IRQ_TID, now, s="g", cat="lost",
+                          name="%d records lost" % arg)
+            if event in (EV_SWITCH, EV_BLOCK, EV_READY, EV_TIMEOUT,
+                         EV_PRIO):
+                self.tasks.add(task)
+            if event in (EV_SWITCH, EV_READY):
+                self.tasks.add(arg)
+
+        # Close what is still open at the end of the trace
+        for task, start in self.run_start.items():
+            self.span(task, start, end, self.name(task), "run")
+        for task, (start, state, _) in self.blocked.items():
+            self.span(task, start, end,
+                      "wait " + WAIT_STATES.get(state, str(state)), "wait")
+        for task, start in self.ready.items():
+            self.span(task, start, end, "ready", "sched")
+        while self.irqs:
+            self.irqs.pop()
+            self.emit("E", IRQ_TID, end)
+
+    def metadata(self):
+        meta = [{"ph": "M", "pid": PID, "name": "process_name",
+                 "args": {"name": "rtx"}},
+                {"ph": "M", "pid": PID, "tid": IRQ_TID, "name": "thread_name",
+                 "args": {"name": "interrupts"}},
+                {"ph": "M", "pid": PID, "tid": IRQ_TID,
+                 "name": "thread_sort_index", "args": {"sort_index": -1}}]
+        for task in sorted(self.tasks):
+            meta.append({"ph": "M", "pid": PID, "tid": task,
+                         "name": "thread_name",
+                         "args": {"name": self.name(task)}})
+        return meta
+
+
+def main():
+    ap = argparse.ArgumentParser(
+        description="Convert an RTX kernel trace dump to Chrome trace JSON")
+    ap.add_argument("input", help="raw dump or console log, - for stdin")
+    ap.add_argument("-o", "--output", default="-",
+                    help="JSON file to write, default stdout")
+    ap.add_argument("--name", action="append", default=[],
+                    metavar="ID=NAME", help="name the task with this ID")
+    opts = ap.parse_args()
+
+    names = {}
+    for item in opts.name:
+        tid, _, name = item.partition("=")
+        names[int(tid, 0)] = name
+
+    if opts.input == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(opts.input, "rb") as f:
+            data = f.read()
+
+    freq, records = decode(parse_words(data))
+    conv = Converter(freq, names)
+    conv.run(unwrap(records))
+
+    trace = {"traceEvents": conv.metadata() + conv.events,
+             "displayTimeUnit": "ns"}
+    if opts.output == "-":
+        json.dump(trace, sys.stdout)
+    else:
+        with open(opts.output, "w") as f:
+            json.dump(trace, f)
+    sys.stderr.write("%d records, %d events\n" %
+                     (len(records), len(conv.events)))
+
+
+if __name__ == "__main__":
+    main()